@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "bench.h"
+#include "post/base64.h"
+#include "post/compiler.h"
+
+#define ITERATIONS 20
+#define PAYLOAD    (4 << 20)
+#define CHUNK      4096
+
+static PostError
+PostBenchSetClipboard(UNUSED PostAppState* appState,
+                      UNUSED puint8        selection,
+                      UNUSED const char*   text)
+{
+  return POST_ERR_NONE;
+}
+
+int
+main(void)
+{
+  puint8*      data    = malloc(PAYLOAD);
+  char*        encoded = malloc(PostBase64EncodedSize(PAYLOAD) + 16);
+  puint8*      decoded = malloc(PostBase64DecodedSize(CHUNK) + PAYLOAD);
+  PostAppState appState;
+  PostRenderer renderer;
+  pusize       encodedSize = 0, decodedSize;
+  double       start;
+  const char*  path = PostBase64IsVectorized() ? "ssse3" : "scalar";
+  char         name[32];
+
+  if (data == NULL || encoded == NULL || decoded == NULL ||
+      PostBenchCreateApp(&appState, &renderer, 200, 50)) {
+    fprintf(stderr,
+            "bench-base64: %s\n",
+            PostErrorString(POST_ERR_OUT_OF_MEMORY));
+    return 1;
+  }
+
+  srand(1);
+  for (pusize i = 0; i < PAYLOAD; ++i)
+    data[i] = rand();
+
+  start = PostBenchNow();
+
+  for (int i = 0; i < ITERATIONS; ++i)
+    encodedSize = PostBase64Encode(data, PAYLOAD, encoded);
+
+  snprintf(name, sizeof(name), "base64 encode (%s)", path);
+  PostBenchReport(name, PAYLOAD * ITERATIONS, PostBenchNow() - start);
+
+  // NOTE: decoded in read sized chunks the way OSC 52 payloads arrive
+  start = PostBenchNow();
+
+  for (int i = 0; i < ITERATIONS; ++i) {
+    PostBase64Decoder decoder;
+
+    PostBase64DecoderReset(&decoder);
+    decodedSize = 0;
+
+    for (pusize j = 0; j < encodedSize; j += CHUNK)
+      decodedSize += PostBase64Decode(&decoder,
+                                      (const puint8*) encoded + j,
+                                      encodedSize - j < CHUNK ? encodedSize - j
+                                                              : CHUNK,
+                                      decoded + decodedSize);
+
+    decodedSize += PostBase64DecodeFinish(&decoder, decoded + decodedSize);
+  }
+
+  snprintf(name, sizeof(name), "base64 decode (%s)", path);
+  PostBenchReport(name, encodedSize * ITERATIONS, PostBenchNow() - start);
+
+  if (decodedSize != PAYLOAD || memcmp(decoded, data, PAYLOAD)) {
+    fprintf(stderr, "bench-base64: round trip mismatch\n");
+    return 1;
+  }
+
+  // NOTE: the whole path, parser included, for an OSC 52 set
+  renderer.SetClipboard = PostBenchSetClipboard;
+  start                 = PostBenchNow();
+
+  for (int i = 0; i < ITERATIONS; ++i) {
+    PostAppWriteBytes(&appState, (const puint8*) "\x1b]52;c;", 7);
+
+    for (pusize j = 0; j < encodedSize; j += CHUNK)
+      PostAppWriteBytes(&appState,
+                        (const puint8*) encoded + j,
+                        encodedSize - j < CHUNK ? encodedSize - j : CHUNK);
+
+    PostAppWriteBytes(&appState, (const puint8*) "\x07", 1);
+  }
+
+  snprintf(name, sizeof(name), "OSC 52 set (%s)", path);
+  PostBenchReport(name, encodedSize * ITERATIONS, PostBenchNow() - start);
+
+  PostAppFini(&appState);
+  free(data);
+  free(encoded);
+  free(decoded);
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+#ifndef POST_BENCH_H
+#define POST_BENCH_H 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "post/app.h"
+
+#define POST_BENCH_MIB (1024.0 * 1024.0)
+
+static inline double
+PostBenchNow(void)
+{
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static inline void
+PostBenchReport(const char* name, pusize bytes, double seconds)
+{
+  printf("%-24s %10.1f MiB/s (%.3f s)\n",
+         name,
+         bytes / POST_BENCH_MIB / seconds,
+         seconds);
+}
+
+static inline void
+PostBenchReportRate(const char* name, pusize count, double seconds)
+{
+  printf(
+    "%-24s %10.1f M/s   (%.3f s)\n", name, count / 1e6 / seconds, seconds);
+}
+
+static inline void
+PostBenchReportLatency(const char* name, pusize count, double seconds)
+{
+  printf("%-24s %10.2f us/op (%.3f s)\n", name, seconds * 1e6 / count, seconds);
+}
+
+/**
+ * headless app with a width x height grid, the renderer only exists to size
+ * the grid so one pixel maps to one cell
+ */
+static inline PostError
+PostBenchCreateApp(PostAppState* appState,
+                   PostRenderer* renderer,
+                   puint32       width,
+                   puint32       height)
+{
+  PostAppInit(appState);
+
+  *renderer = (PostRenderer) {
+    .windowWidth  = width,
+    .windowHeight = height,
+    .cellWidth    = 1,
+    .cellHeight   = 1,
+  };
+
+  appState->renderer = renderer;
+
+  return PostAppSizeGrid(appState);
+}
+
+#endif
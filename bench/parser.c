@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "bench.h"
+
+#define ITERATIONS 100
+
+static const char* sgrLines[] = {
+  "\x1b[0m\x1b[01;34mbin\x1b[0m  \x1b[01;36mlib64\x1b[0m  "
+  "\x1b[30;42mtmp\x1b[0m  \x1b[01;32mconfigure\x1b[0m\r\n",
+  "\x1b[1m\x1b[31m  PID\x1b[39m \x1b[32mUSER\x1b[39m     \x1b[7mPRI\x1b[27m "
+  "\x1b[4;33mNI\x1b[24;39m  VIRT   RES\x1b[22m\r\n",
+  "\x1b[38;5;208m\x1b[48;5;236m  1.2%\x1b[0m \x1b[90m[\x1b[92m||||\x1b[91m||"
+  "\x1b[90m]\x1b[0m\x1b[K\r\n",
+  "\x1b[3;9;2m  deprecated\x1b[23;29;22m \x1b[2;5Hfoo\x1b[;3Hbar\x1b[m\r\n",
+};
+
+static const char* plainLines[] = {
+  "[ 42%] Building C object CMakeFiles/post.dir/src/parser.c.o\r\n",
+  "cc -Iinclude -std=c11 -Wall -Wextra -O2 -c src/app.c -o build/app.o\r\n",
+  "Apr 11 09:12:01 host kernel: usb 1-1: new high-speed USB device number 3\r\n",
+  "\tat org.example.Service.handle(Service.java:118)\r\n",
+};
+
+static const char* utf8Lines[] = {
+  "2024-04-11 09:12:01 INFO  \xe2\x9c\x94 build succeeded in 3.2s\r\n",
+  "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe3\x83\x86"
+  "\xe3\x82\xad\xe3\x82\xb9\xe3\x83\x88 mixed with ASCII\r\n",
+  "caf\xc3\xa9 na\xc3\xafve r\xc3\xa9sum\xc3\xa9 \xe2\x80\x94 "
+  "\xf0\x9f\x9a\x80 deployed\r\n",
+  "\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 "
+  "\xd0\xbc\xd0\xb8\xd1\x80\r\n",
+};
+
+// NOTE: a full-screen TUI repainting, every frame erases the screen and then
+// erases the rest of each line it writes
+static const char* redrawLines[] = {
+  "\x1b[H\x1b[2Jtop - 09:12:01 up 3 days,  2 users,  load average: 0.42\x1b[K",
+  "\x1b[2;1HTasks: 211 total,   1 running, 210 sleeping\x1b[K",
+  "\x1b[4;1H\x1b[7m  PID USER      PR  NI    VIRT    RES\x1b[m\x1b[K",
+  "\x1b[5;1H 1042 post      20   0  812344  61232\x1b[K\x1b[J",
+};
+
+// NOTE: the same kind of repaint as curses sends it with the post terminfo
+// entry, runs of one character are REP, blanks are ECH and moves are VPA/HPA
+static const char* cursesLines[] = {
+  "\x1b[1;1H\xe2\x94\x8c\x1b[197b\xe2\x94\x90",
+  "\x1b[2d\x1b[2`  PID USER\x1b[40X\x1b[60`VIRT    RES\x1b[K",
+  "\x1b[3;5H\x1b[7m \x1b[120b\x1b[m\x1b[3P",
+  "\x1b[3;30H\x1b[32m|\x1b[17b\x1b[m\x1b[4;1H\x1b[2M\x1b[48;1H\x1b[2L",
+};
+
+#define PostBenchLines(LINES) (LINES), (sizeof(LINES) / sizeof(*(LINES)))
+
+static puint8*
+PostBenchBuildInput(const char** lines,
+                    pusize       numLines,
+                    pusize       minSize,
+                    pusize*      size)
+{
+  pusize  len = 0, cap = minSize + 256;
+  puint8* buf = malloc(cap);
+
+  if (buf == NULL)
+    return NULL;
+
+  for (pusize i = 0; len < minSize; ++i) {
+    const char* line    = lines[i % numLines];
+    pusize      lineLen = strlen(line);
+    memcpy(buf + len, line, lineLen);
+    len += lineLen;
+  }
+
+  *size = len;
+
+  return buf;
+}
+
+static int
+PostBenchParser(const char* name, const char** lines, pusize numLines)
+{
+  PostAppState appState;
+  PostRenderer renderer;
+  pusize       size;
+  puint8*      input = PostBenchBuildInput(lines, numLines, 1 << 20, &size);
+
+  if (input == NULL || PostBenchCreateApp(&appState, &renderer, 200, 50)) {
+    fprintf(stderr,
+            "bench-parser: %s\n",
+            PostErrorString(POST_ERR_OUT_OF_MEMORY));
+    free(input);
+    return 1;
+  }
+
+  double start = PostBenchNow();
+
+  for (int i = 0; i < ITERATIONS; ++i)
+    PostAppWriteBytes(&appState, input, size);
+
+  PostBenchReport(name, size * ITERATIONS, PostBenchNow() - start);
+
+  PostAppFini(&appState);
+  free(input);
+
+  return 0;
+}
+
+int
+main(void)
+{
+  if (PostBenchParser("parser (SGR-dense)", PostBenchLines(sgrLines)))
+    return 1;
+
+  if (PostBenchParser("parser (plain ASCII)", PostBenchLines(plainLines)))
+    return 1;
+
+  if (PostBenchParser("parser (UTF-8)", PostBenchLines(utf8Lines)))
+    return 1;
+
+  if (PostBenchParser("parser (full redraw)", PostBenchLines(redrawLines)))
+    return 1;
+
+  if (PostBenchParser("parser (curses redraw)", PostBenchLines(cursesLines)))
+    return 1;
+
+  return 0;
+}
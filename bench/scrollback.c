@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "bench.h"
+
+#define LINES     500000
+#define LOOKUPS   20000
+#define RESIZES   1000
+#define MEM_PAGES 8
+
+static const char* logLines[] = {
+  "2024-04-11 09:12:01 \x1b[32mINFO \x1b[m [worker-3] request %d handled\r\n",
+  "2024-04-11 09:12:01 \x1b[33mWARN \x1b[m [worker-1] slow query %d\r\n",
+  "[ 42%%] Building C object CMakeFiles/post.dir/src/parser.c.o %d\r\n",
+  "\tat org.example.Service.handle(Service.java:%d)\r\n",
+};
+
+/** reads the screenful of lines starting at line i, returns the cells seen */
+static pusize
+PostBenchReadScreen(PostAppState* appState, puint64 i, puint32 height)
+{
+  pusize cells = 0;
+
+  for (puint32 y = 0; y < height && i + y < appState->scrollback.numLines;
+       ++y) {
+    puint32 len;
+
+    PostScrollbackLine(appState, i + y, &len, NULL);
+    cells += len;
+  }
+
+  return cells;
+}
+
+int
+main(void)
+{
+  PostAppState appState;
+  PostRenderer renderer;
+  pusize       size = 0, cells = 0;
+  puint64      numLines;
+  double       start;
+
+  if (PostBenchCreateApp(&appState, &renderer, 200, 50)) {
+    fprintf(stderr,
+            "bench-scrollback: %s\n",
+            PostErrorString(POST_ERR_OUT_OF_MEMORY));
+    return 1;
+  }
+
+  // NOTE: a small ring so nearly all of the history ends up in the file
+  PostScrollbackFini(&appState.scrollback);
+  PostScrollbackInit(
+    &appState.scrollback, MEM_PAGES * POST_SCROLLBACK_PAGE_SIZE, 1);
+
+  start = PostBenchNow();
+
+  for (int i = 0; i < LINES; ++i) {
+    char line[128];
+    int  len = snprintf(line, sizeof(line), logLines[i % 4], i);
+
+    PostAppWriteBytes(&appState, (const puint8*) line, len);
+    size += len;
+  }
+
+  PostBenchReport("scrollback (spill)", size, PostBenchNow() - start);
+
+  numLines = appState.scrollback.numLines;
+
+  if (!appState.scrollback.spill || !appState.scrollback.numSpilled) {
+    fprintf(stderr, "bench-scrollback: nothing was spilled\n");
+    PostAppFini(&appState);
+    return 1;
+  }
+
+  printf("%-24s %10llu lines in %u spilled pages\n",
+         "scrollback (history)",
+         (unsigned long long) numLines,
+         appState.scrollback.numSpilled);
+
+  // NOTE: paging up a screen at a time from the newest line to the oldest,
+  // every spilled page is read back once
+  start = PostBenchNow();
+
+  for (puint64 i = 0; i < numLines; i += appState.grid.height)
+    cells += PostBenchReadScreen(&appState, i, appState.grid.height);
+
+  PostBenchReportRate(
+    "scrollback (page up)", numLines, PostBenchNow() - start);
+
+  // NOTE: jumping around the history misses the cache nearly every time so
+  // this is the latency of mapping a page back in and unpacking it
+  srand(1);
+  start = PostBenchNow();
+
+  for (int i = 0; i < LOOKUPS; ++i)
+    cells += PostBenchReadScreen(&appState,
+                                 (puint64) rand() * rand() % numLines,
+                                 appState.grid.height);
+
+  PostBenchReportLatency(
+    "scrollback (page-in)", LOOKUPS, PostBenchNow() - start);
+
+  // NOTE: resizing only reflows the screen and the newest line, however long
+  // the history is
+  start = PostBenchNow();
+
+  for (int i = 0; i < RESIZES; ++i) {
+    PostError err;
+
+    renderer.windowWidth = i & 1 ? 120 : 200;
+
+    if ((err = PostAppSizeGrid(&appState))) {
+      fprintf(stderr, "bench-scrollback: %s\n", PostErrorString(err));
+      PostAppFini(&appState);
+      return 1;
+    }
+  }
+
+  PostBenchReportLatency(
+    "scrollback (resize)", RESIZES, PostBenchNow() - start);
+
+  PostAppFini(&appState);
+
+  return !cells;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "bench.h"
+#include "post/width.h"
+
+#define ITERATIONS 200
+#define CODEPOINTS (1 << 16)
+
+/** codepoint ranges the benchmark input is drawn from */
+static const puint32 ranges[][2] = {
+  { 0x0020, 0x007E },   // ASCII
+  { 0x00A0, 0x024F },   // Latin-1 and Latin Extended
+  { 0x0300, 0x036F },   // combining diacritics
+  { 0x0400, 0x04FF },   // Cyrillic
+  { 0x3040, 0x30FF },   // Hiragana and Katakana
+  { 0x4E00, 0x9FFF },   // CJK ideographs
+  { 0xAC00, 0xD7A3 },   // Hangul syllables
+  { 0x1F300, 0x1F64F }, // emoji
+  { 0x0000, 0x10FFFF }, // anything
+};
+
+#define NUM_RANGES (sizeof(ranges) / sizeof(*ranges))
+
+int
+main(void)
+{
+  puint32* codepoints = malloc(CODEPOINTS * sizeof(*codepoints));
+  pusize   total      = 0;
+  double   start;
+
+  if (codepoints == NULL) {
+    fprintf(stderr,
+            "bench-width: %s\n",
+            PostErrorString(POST_ERR_OUT_OF_MEMORY));
+    return 1;
+  }
+
+  srand(1);
+
+  for (puint32 i = 0; i < CODEPOINTS; ++i) {
+    const puint32* range = ranges[rand() % NUM_RANGES];
+    puint32        span  = range[1] - range[0] + 1;
+    codepoints[i] = range[0] + (puint32) rand() % span;
+  }
+
+  start = PostBenchNow();
+
+  for (int i = 0; i < ITERATIONS; ++i)
+    for (puint32 j = 0; j < CODEPOINTS; ++j)
+      total += PostCodepointWidth(codepoints[j]);
+
+  PostBenchReportRate("width (mixed lookups)",
+                      (pusize) ITERATIONS * CODEPOINTS,
+                      PostBenchNow() - start);
+
+  // NOTE: keeps the loop from being optimized away
+  if (!total)
+    fprintf(stderr, "bench-width: no widths\n");
+
+  free(codepoints);
+
+  return 0;
+}
@@ -1,100 +1,415 @@
 #ifndef POST_APP_H
 #define POST_APP_H 1
 
-#include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 
+#include "cell.h"
+#include "cluster.h"
 #include "color.h"
 #include "config.h"
 #include "error.h"
+#include "log.h"
+#include "palette.h"
 #include "parser.h"
 #include "renderer.h"
+#include "scrollback.h"
+#include "style.h"
 
-#define POST_CELL_SGR_BOLD          (1 << 0)
-#define POST_CELL_SGR_FAINT         (1 << 1)
-#define POST_CELL_SGR_ITALIC        (1 << 2)
-#define POST_CELL_SGR_UNDERLINE     (1 << 3)
-#define POST_CELL_SGR_SLOW_BLINK    (1 << 4)
-#define POST_CELL_SGR_RAPID_BLINK   (1 << 5)
-#define POST_CELL_SGR_INVERT        (1 << 6)
-#define POST_CELL_SGR_CONCEAL       (1 << 7)
-#define POST_CELL_SGR_STRIKE        (1 << 8)
-#define POST_CELL_SGR_DBL_UNDERLINE (1 << 9)
+/**
+ * rows are stored as a ring, row y of the screen is physical row
+ * rows[(head + y) % height] of cells, scrolling the whole screen moves head
+ * and scrolling a region permutes rows without touching any cell
+ *
+ * blankFrom is indexed by physical row, the cells of a row from blankFrom on
+ * are blank whatever is stored there and hold no references, erasing to the
+ * end of a row only moves the marker and the blank cells are written out
+ * once something is drawn over them
+ *
+ * wrapped is indexed by physical row too and is set when the text of a row
+ * ran past the last column and went on in the row below, resizing joins such
+ * rows back up and wraps them again at the new width
+ *
+ * damage is indexed by screen row instead, it holds the columns of each row
+ * that changed since the renderer last drew it, resizing or switching screens
+ * damages the whole grid
+ *
+ * scrolls logs the regions scrolled since then so the renderer can move what
+ * it drew instead of drawing it again, the damage of a scrolled row moves
+ * with it and only the rows scrolled in are damaged, once the log is full a
+ * scroll damages its whole region instead
+ */
+typedef struct
+{
+  puint32 start, end;
+} PostRowDamage;
 
+#define POST_GRID_MAX_SCROLLS 4
+
+/** rows top to bottom (inclusive) moved up by delta rows, down when negative */
 typedef struct
 {
-  puint32   charCode;
-  PostColor fg, bg;
-  puint16   sgr;
-} PostCell;
+  puint32 top, bottom;
+  pint32  delta;
+} PostGridScroll;
 
 typedef struct
 {
-  pusize    byteSize;
-  puint32   width, height;
-  PostCell* cells;
+  pusize         byteSize;
+  puint32        width, height;
+  PostCell*      cells;
+  puint32*       rows;
+  puint32*       blankFrom;
+  pbool*         wrapped;
+  PostRowDamage* damage;
+  PostGridScroll scrolls[POST_GRID_MAX_SCROLLS];
+  puint32        numScrolls;
+  puint32        head;
 } PostCellGrid;
 
+static inline puint32*
+PostGridRowSlot(const PostCellGrid* grid, puint32 y)
+{
+  puint32 i = grid->head + y;
+
+  if (i >= grid->height)
+    i -= grid->height;
+
+  return grid->rows + i;
+}
+
+/** the stored cells of row y, only those before its blank marker are valid */
+static inline PostCell*
+PostGridRow(const PostCellGrid* grid, puint32 y)
+{
+  return grid->cells + (pusize) *PostGridRowSlot(grid, y) * grid->width;
+}
+
+static inline puint32*
+PostGridBlankFrom(const PostCellGrid* grid, puint32 y)
+{
+  return grid->blankFrom + *PostGridRowSlot(grid, y);
+}
+
+static inline pbool*
+PostGridWrapped(const PostCellGrid* grid, puint32 y)
+{
+  return grid->wrapped + *PostGridRowSlot(grid, y);
+}
+
+/** marks the columns [start, end) of screen row y to be drawn again */
+static inline void
+PostGridDamage(PostCellGrid* grid, puint32 y, puint32 start, puint32 end)
+{
+  PostRowDamage* damage = grid->damage + y;
+
+  if (damage->start >= damage->end) {
+    damage->start = start;
+    damage->end   = end;
+    return;
+  }
+
+  if (start < damage->start)
+    damage->start = start;
+  if (end > damage->end)
+    damage->end = end;
+}
+
+/**
+ * marks the whole of rows top to bottom (inclusive) to be drawn again, the
+ * scroll log is dropped when that is every row
+ */
+static inline void
+PostGridDamageRows(PostCellGrid* grid, puint32 top, puint32 bottom)
+{
+  for (puint32 y = top; y <= bottom; ++y)
+    grid->damage[y] = (PostRowDamage) { .start = 0, .end = grid->width };
+
+  if (!top && bottom + 1 == grid->height)
+    grid->numScrolls = 0;
+}
+
+/**
+ * row y ready to be written before column end, the blank cells under its
+ * marker up to end are written out first
+ */
+static inline PostCell*
+PostGridRowWrite(PostCellGrid* grid, puint32 y, puint32 end)
+{
+  PostCell* row       = PostGridRow(grid, y);
+  puint32*  blankFrom = PostGridBlankFrom(grid, y);
+
+  if (*blankFrom < end) {
+    memset(row + *blankFrom, 0, (end - *blankFrom) * sizeof(PostCell));
+    *blankFrom = end;
+  }
+
+  return row;
+}
+
+/** the cell at column x of row y, blank past the row's marker */
+static inline PostCell
+PostGridCell(const PostCellGrid* grid, puint32 x, puint32 y)
+{
+  if (x >= *PostGridBlankFrom(grid, y))
+    return (PostCell) { 0 };
+  return PostGridRow(grid, y)[x];
+}
+
 typedef struct PostCursor
 {
   pbool     visible;
   pbool     lastColumnFlag;
   puint64   time;
   puint32   x, y;
-  PostColor fg, bg;
-  puint16   sgr;
+  /** attributes set by SGR, interned into style once per sequence */
+  PostStyle attrs;
+  puint16   style;
 } PostCursor;
 
 typedef struct PostProcess PostProcess;
 
 typedef struct PostAppState
 {
-  PostConfig    config;
-  PostParser    parser;
-  PostCursor    cursor;
-  PostCellGrid  grid;
-  PostRenderer* renderer;
-  FILE*         master;
-  PostProcess*  childProcess;
-  void (*LogInfo)(struct PostAppState*, const char*, va_list);
-  void (*LogWarning)(struct PostAppState*, const char*, va_list);
+  PostConfig       config;
+  PostParser       parser;
+  PostCursor       cursor;
+  /** DECSC, saved by ESC 7 and DECSET 1048 and 1049 */
+  PostCursor       savedCursor;
+  /** the screen that is shown and written to */
+  PostCellGrid     grid;
+  /**
+   * the screen that is not shown, the alternate one while the primary screen
+   * is up and the other way round, switching swaps it with grid, it is
+   * allocated on the first switch and again only after a resize
+   */
+  PostCellGrid     otherGrid;
+  pbool            altScreen;
+  PostScrollback   scrollback;
+  PostStyleTable   styles;
+  /** grapheme clusters referenced by the cells, see post/cluster.h */
+  PostClusterTable clusters;
+  PostPalette      palette;
+  /** DECSTBM margins, the rows that line feeds and IL/DL/SU/SD scroll */
+  puint32          scrollTop, scrollBottom;
+  PostRenderer*    renderer;
+  FILE*            master;
+  PostProcess*     childProcess;
+  PostLogger       logger;
+  PostString       title;
+  pbool            titleDirty;
+  /** log sinks, called from the logging thread once it is started */
+  void (*LogInfo)(struct PostAppState*, const char*);
+  void (*LogWarning)(struct PostAppState*, const char*);
+  /** writes a response (for example to a query) back to the child */
+  PostError (*Reply)(struct PostAppState*, const char*, pusize);
   void (*DestroyApp)(struct PostAppState*);
 } PostAppState;
 
 void
-PostAppWriteASCIIString(PostAppState* appState, const char* str);
+PostAppInit(PostAppState* appState);
+
+void
+PostAppFini(PostAppState* appState);
+
+/**
+ * feeds exactly len bytes of child output through the parser and returns the
+ * number of bytes consumed, parser state carries over between calls so a
+ * buffer may be split anywhere (including inside an escape sequence)
+ */
+pusize
+PostAppWriteBytes(PostAppState* appState, const puint8* data, pusize len);
+
+/**
+ * writes a run of printable ASCII, one row segment at a time, with the cursor
+ * style broadcast across every cell and wrapping handled once per row
+ */
+void
+PostAppWriteASCII(PostAppState* appState,
+                  PostCursor*   cursor,
+                  const puint8* run,
+                  pusize        len);
+
+void
+PostAppWriteCodepoints(PostAppState*  appState,
+                       PostCursor*    cursor,
+                       const puint32* codepoints,
+                       pusize         len);
+
+/**
+ * attaches codepoint to the grapheme cluster in the cell before the cursor,
+ * the cell keeps the width of its first codepoint
+ */
+void
+PostAppExtendCluster(PostAppState* appState,
+                     PostCursor*   cursor,
+                     puint32       codepoint);
+
+/** performs the C0 control ch, unsupported controls are ignored */
+void
+PostAppExecute(PostAppState* appState, PostCursor* cursor, puint8 ch);
 
+/** moves the cursor to the start of the next line, scrolling at the bottom */
+void
+PostAppNextLine(PostAppState* appState, PostCursor* cursor);
+
+/** moves the cursor down a line, scrolling at the bottom margin */
+void
+PostAppIndex(PostAppState* appState, PostCursor* cursor);
+
+/** moves the cursor up a line, scrolling down at the top margin */
+void
+PostAppReverseIndex(PostAppState* appState, PostCursor* cursor);
+
+/**
+ * scrolls rows top to bottom (inclusive) up by n, the rows uncovered at the
+ * bottom are cleared
+ */
+void
+PostAppScrollUp(PostAppState* appState,
+                puint32       top,
+                puint32       bottom,
+                puint32       n);
+
+/** the reverse of PostAppScrollUp, rows uncovered at the top are cleared */
+void
+PostAppScrollDown(PostAppState* appState,
+                  puint32       top,
+                  puint32       bottom,
+                  puint32       n);
+
+/**
+ * sizes the grid to the renderer's window, the text on the screen is
+ * reflowed to the new width, rows that no longer fit above the cursor go to
+ * the scrollback and a line that wrapped off the top of the screen is taken
+ * back first so it is reflowed whole, while the alternate screen is up it is
+ * only cut to size and the primary screen is reflowed behind it
+ */
 PostError
 PostAppSizeGrid(PostAppState* appState);
 
-static inline PostError
-PostAppSetTitle(PostAppState* appState, const char* title)
-{
-  if (appState->renderer == NULL || appState->renderer->SetWindowTitle == NULL)
-    return POST_ERR_UNSUPPORTED;
-  return appState->renderer->SetWindowTitle(appState, title);
-}
+/** DECSC, saves the cursor's position and attributes */
+void
+PostAppSaveCursor(PostAppState* appState, PostCursor* cursor);
+
+/** DECRC, the home position in the default style if nothing was saved */
+void
+PostAppRestoreCursor(PostAppState* appState, PostCursor* cursor);
+
+/**
+ * switches to the alternate screen (DECSET 47, 1047 and 1049) and back, the
+ * screens are swapped and no cell is copied, the alternate screen is cleared
+ * on the way in when clear is set and never reaches the scrollback
+ */
+PostError
+PostAppSetAltScreen(PostAppState* appState,
+                    PostCursor*   cursor,
+                    pbool         alt,
+                    pbool         clear);
 
+/**
+ * stores the title until the next frame, programs that update it many times
+ * per frame only cost a copy
+ */
+PostError
+PostAppSetTitle(PostAppState* appState, const char* title, pusize len);
+
+/** applies the pending title if it changed, called once per rendered frame */
+PostError
+PostAppFlushTitle(PostAppState* appState);
+
+/**
+ * drops the style and cluster references of n cells that are about to be
+ * overwritten, runs of one style are released together
+ */
 static inline void
-PostAppLogInfo(PostAppState* appState, const char* fmt, ...)
+PostAppReleaseCells(PostAppState* appState, const PostCell* cells, puint32 n)
 {
-  if (appState->LogInfo != NULL) {
-    va_list args;
-    va_start(args, fmt);
-    appState->LogInfo(appState, fmt, args);
-    va_end(args);
+  if (!n)
+    return;
+
+  if (appState->styles.numLive) {
+    puint16 style = cells[0].style;
+    puint32 count = 1;
+
+    for (puint32 i = 1; i < n; ++i) {
+      if (cells[i].style == style)
+        ++count;
+      else {
+        PostStyleRelease(&appState->styles, style, count);
+        style = cells[i].style;
+        count = 1;
+      }
+    }
+
+    PostStyleRelease(&appState->styles, style, count);
   }
+
+  if (appState->clusters.numLive)
+    for (puint32 i = 0; i < n; ++i)
+      PostClusterRelease(&appState->clusters, cells[i].charCode);
 }
 
+/**
+ * blanks the half of a wide character left outside of the columns [x0, x1)
+ * that are about to be overwritten
+ */
 static inline void
-PostAppLogWarning(PostAppState* appState, const char* fmt, ...)
+PostAppSplitWide(PostAppState* appState, puint32 y, puint32 x0, puint32 x1)
 {
-  if (appState->LogWarning != NULL) {
-    va_list args;
-    va_start(args, fmt);
-    appState->LogWarning(appState, fmt, args);
-    va_end(args);
+  PostCell* row       = PostGridRow(&appState->grid, y);
+  puint32   blankFrom = *PostGridBlankFrom(&appState->grid, y);
+
+  if (x0 < blankFrom && row[x0].flags & POST_CELL_WIDE_SPACER) {
+    PostClusterRelease(&appState->clusters, row[x0 - 1].charCode);
+    row[x0 - 1].charCode = 0;
+    row[x0 - 1].flags    = 0;
+    PostGridDamage(&appState->grid, y, x0 - 1, x0);
   }
+
+  if (x1 < blankFrom && row[x1].flags & POST_CELL_WIDE_SPACER) {
+    row[x1].charCode = 0;
+    row[x1].flags    = 0;
+    PostGridDamage(&appState->grid, y, x1, x1 + 1);
+  }
+}
+
+/**
+ * blanks the columns [start, end) of row y, when the range reaches the row's
+ * blank marker the marker is moved instead of writing any cell
+ */
+void
+PostAppEraseCells(PostAppState* appState,
+                  puint32       y,
+                  puint32       start,
+                  puint32       end);
+
+/** interns the cursor attributes after they were changed */
+void
+PostAppUpdateStyle(PostAppState* appState, PostCursor* cursor);
+
+static inline PostError
+PostAppSetClipboard(PostAppState* appState, puint8 selection, const char* text)
+{
+  if (appState->renderer == NULL || appState->renderer->SetClipboard == NULL)
+    return POST_ERR_UNSUPPORTED;
+  return appState->renderer->SetClipboard(appState, selection, text);
+}
+
+static inline PostError
+PostAppGetClipboard(PostAppState* appState, puint8 selection, PostString* text)
+{
+  if (appState->renderer == NULL || appState->renderer->GetClipboard == NULL)
+    return POST_ERR_UNSUPPORTED;
+  return appState->renderer->GetClipboard(appState, selection, text);
+}
+
+static inline PostError
+PostAppReply(PostAppState* appState, const char* buf, pusize len)
+{
+  if (appState->Reply == NULL)
+    return POST_ERR_UNSUPPORTED;
+  return appState->Reply(appState, buf, len);
 }
 
 static inline void
@@ -0,0 +1,56 @@
+#ifndef POST_BASE64_H
+#define POST_BASE64_H 1
+
+#include "post/types.h"
+
+/**
+ * a partially decoded quantum, kept between calls so the encoded text may be
+ * split anywhere
+ */
+typedef struct
+{
+  puint32 bits;
+  puint8  numChars;
+  pbool   padded;
+  pbool   invalid;
+} PostBase64Decoder;
+
+/** upper bound on the bytes written by one PostBase64Decode call */
+#define PostBase64DecodedSize(LEN) ((LEN) / 4 * 3 + 16)
+
+/** exact number of characters PostBase64Encode writes */
+#define PostBase64EncodedSize(LEN) (((LEN) + 2) / 3 * 4)
+
+static inline void
+PostBase64DecoderReset(PostBase64Decoder* decoder)
+{
+  *decoder = (PostBase64Decoder) { 0 };
+}
+
+/**
+ * decodes standard base64 with optional padding and returns the number of
+ * bytes written to out, which must hold PostBase64DecodedSize(len) bytes.
+ * Decoding stops on the first invalid character and sets decoder->invalid.
+ */
+pusize
+PostBase64Decode(PostBase64Decoder* decoder,
+                 const puint8*      in,
+                 pusize             len,
+                 puint8*            out);
+
+/**
+ * writes the bytes of an unpadded final quantum and returns their count, or
+ * marks the decoder invalid when the input ended mid quantum
+ */
+pusize
+PostBase64DecodeFinish(PostBase64Decoder* decoder, puint8* out);
+
+/** encodes with padding, returns PostBase64EncodedSize(len) */
+pusize
+PostBase64Encode(const puint8* in, pusize len, char* out);
+
+/** whether this CPU runs the SSSE3 shuffle codec rather than the scalar one */
+pbool
+PostBase64IsVectorized(void);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef POST_CELL_H
+#define POST_CELL_H 1
+
+#include "post/types.h"
+
+#define POST_CELL_SGR_BOLD          (1 << 0)
+#define POST_CELL_SGR_FAINT         (1 << 1)
+#define POST_CELL_SGR_ITALIC        (1 << 2)
+#define POST_CELL_SGR_UNDERLINE     (1 << 3)
+#define POST_CELL_SGR_SLOW_BLINK    (1 << 4)
+#define POST_CELL_SGR_RAPID_BLINK   (1 << 5)
+#define POST_CELL_SGR_INVERT        (1 << 6)
+#define POST_CELL_SGR_CONCEAL       (1 << 7)
+#define POST_CELL_SGR_STRIKE        (1 << 8)
+#define POST_CELL_SGR_DBL_UNDERLINE (1 << 9)
+
+/**
+ * a wide character is stored in its first cell with POST_CELL_WIDE set, the
+ * cell to its right is an empty POST_CELL_WIDE_SPACER
+ */
+#define POST_CELL_WIDE        (1 << 0)
+#define POST_CELL_WIDE_SPACER (1 << 1)
+
+/** style is an id in PostAppState.styles, see post/style.h */
+typedef struct
+{
+  puint32 charCode;
+  puint16 style;
+  puint16 flags;
+} PostCell;
+
+_Static_assert(sizeof(PostCell) == 8, "PostCell is expected to be 8 bytes");
+
+/**
+ * the end of the row starting at cells[start] when the line ending at end is
+ * wrapped at width, a wide character that would straddle the edge starts the
+ * next row instead, on a row too narrow for it at all its spacer is taken
+ * along and the row ends up one cell longer than width
+ */
+static inline puint32
+PostCellWrap(const PostCell* cells, puint32 start, puint32 end, puint32 width)
+{
+  puint32 rowEnd = start + width;
+
+  if (rowEnd >= end)
+    return end;
+
+  if (cells[rowEnd].flags & POST_CELL_WIDE_SPACER)
+    return rowEnd - 1 > start ? rowEnd - 1 : rowEnd + 1;
+
+  return rowEnd;
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef POST_CLIPBOARD_H
+#define POST_CLIPBOARD_H 1
+
+#include "post/base64.h"
+#include "post/string.h"
+#include "post/types.h"
+
+typedef struct PostAppState PostAppState;
+
+/**
+ * an OSC 52 transfer, the base64 payload is decoded as it arrives so a large
+ * selection never has to be buffered in its encoded form
+ */
+typedef struct
+{
+  puint8            selection;
+  pbool             query;
+  pbool             failed;
+  PostBase64Decoder base64;
+  PostString        data;
+} PostClipboardTransfer;
+
+/** starts a transfer for the Pc selection list of OSC 52 */
+void
+PostClipboardBegin(PostClipboardTransfer* transfer,
+                   const puint8*          selection,
+                   pusize                 len);
+
+void
+PostClipboardPut(PostAppState*          appState,
+                 PostClipboardTransfer* transfer,
+                 const puint8*          data,
+                 pusize                 len);
+
+/**
+ * sets the selection or answers a query, terminator is the byte that ended
+ * the OSC so the reply can use the same one
+ */
+void
+PostClipboardEnd(PostAppState*          appState,
+                 PostClipboardTransfer* transfer,
+                 puint8                 terminator);
+
+void
+PostClipboardRelease(PostClipboardTransfer* transfer);
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef POST_CLUSTER_H
+#define POST_CLUSTER_H 1
+
+#include "post/error.h"
+#include "post/types.h"
+
+/**
+ * a cell whose charCode has POST_CLUSTER_TAG set holds the index of a
+ * multi-codepoint grapheme cluster in the PostClusterTable of the app state,
+ * which both screens and the scrollback share
+ */
+#define POST_CLUSTER_TAG  0x80000000u
+#define POST_CLUSTER_NONE 0xFFFFFFFFu
+
+// NOTE: marks past this are dropped so a stream of combining characters
+// can't grow one cell without bound
+#define POST_CLUSTER_MAX_CODEPOINTS 32
+
+#define PostIsCluster(CHAR_CODE) ((CHAR_CODE) & POST_CLUSTER_TAG)
+
+/** refs is 0 for a free entry, offset then links to the next free entry */
+typedef struct
+{
+  puint32 refs;
+  puint32 offset;
+  puint32 len;
+} PostCluster;
+
+/**
+ * codepoints of every cluster live back to back in pool, poolLive counts the
+ * ones still referenced and the pool is compacted once most of it is dead
+ */
+typedef struct
+{
+  PostCluster* clusters;
+  puint32      numClusters, maxClusters;
+  puint32      freeCluster;
+  puint32      numLive;
+  puint32*     pool;
+  puint32      poolSize, maxPool;
+  puint32      poolLive;
+} PostClusterTable;
+
+void
+PostClusterTableInit(PostClusterTable* table);
+
+void
+PostClusterTableFini(PostClusterTable* table);
+
+/** releases every cluster at once, for when the whole grid is cleared */
+void
+PostClusterTableClear(PostClusterTable* table);
+
+/** compacts the pool when more than half of it is unreferenced */
+void
+PostClusterTableTrim(PostClusterTable* table);
+
+/**
+ * appends codepoint to the cluster or plain codepoint in charCode and stores
+ * the tagged result in charCode, the old reference is released
+ */
+PostError
+PostClusterExtend(PostClusterTable* table,
+                  puint32*          charCode,
+                  puint32           codepoint);
+
+static inline void
+PostClusterRetain(PostClusterTable* table, puint32 charCode)
+{
+  if (PostIsCluster(charCode))
+    ++table->clusters[charCode & ~POST_CLUSTER_TAG].refs;
+}
+
+void
+PostClusterFree(PostClusterTable* table, puint32 index);
+
+static inline void
+PostClusterRelease(PostClusterTable* table, puint32 charCode)
+{
+  if (PostIsCluster(charCode) &&
+      !--table->clusters[charCode & ~POST_CLUSTER_TAG].refs)
+    PostClusterFree(table, charCode & ~POST_CLUSTER_TAG);
+}
+
+/** codepoints of charCode, which is either a cluster or a plain codepoint */
+static inline const puint32*
+PostClusterCodepoints(const PostClusterTable* table,
+                      const puint32*          charCode,
+                      puint32*                len)
+{
+  const PostCluster* cluster;
+
+  if (!PostIsCluster(*charCode)) {
+    *len = 1;
+    return charCode;
+  }
+
+  cluster = table->clusters + (*charCode & ~POST_CLUSTER_TAG);
+  *len    = cluster->len;
+
+  return table->pool + cluster->offset;
+}
+
+#endif
@@ -17,4 +17,24 @@ typedef struct
 #define POST_COLOR_BLACK (PostColor) PostColorXXX(0)
 #define POST_COLOR_WHITE (PostColor) PostColorXXX(255)
 
+/**
+ * a colour as the application asked for it, the tag in the top byte says
+ * whether the low bits are a palette index, a direct 0xRRGGBB value or
+ * nothing, in which case the default foreground or background applies,
+ * colour refs are resolved through post/palette.h only when drawing
+ */
+typedef puint32 PostColorRef;
+
+#define POST_COLOR_REF_DEFAULT 0x00000000u
+#define POST_COLOR_REF_PALETTE 0x01000000u
+#define POST_COLOR_REF_RGB     0x02000000u
+
+#define PostColorRefTag(REF) ((REF) & 0xFF000000u)
+
+#define PostColorRefPalette(INDEX) (POST_COLOR_REF_PALETTE | (puint8) (INDEX))
+
+#define PostColorRefRGB(R, G, B)                                               \
+  (POST_COLOR_REF_RGB | ((puint32) (puint8) (R) << 16) |                       \
+   ((puint32) (puint8) (G) << 8) | (puint8) (B))
+
 #endif
@@ -3,11 +3,15 @@
 
 #ifdef __GNUC__
 
-#define UNUSED __attribute__((unused))
+#define UNUSED                   __attribute__((unused))
+#define PRINTF_FORMAT(FMT, ARGS) __attribute__((format(printf, FMT, ARGS)))
+#define TARGET(ISA)              __attribute__((target(ISA)))
 
 #else
 
 #define UNUSED
+#define PRINTF_FORMAT(FMT, ARGS)
+#define TARGET(ISA)
 
 #endif
 
@@ -10,6 +10,16 @@ typedef struct
   PostColor bg;
   puint8    tabWidth;
   pbool     bracketedPasteMode;
+  puint8    logLevel;
+  pusize    maxStringSize;
+  pusize    maxClipboardSize;
+  pbool     allowClipboardRead;
+  /** memory budget of the scrollback in bytes, 0 turns it off */
+  pusize    scrollbackSize;
+  /** keep lines dropped from the scrollback in a temporary file */
+  pbool     scrollbackSpill;
+  /** memory budget of the rendered rows kept for reuse, 0 turns it off */
+  pusize    rowCacheSize;
 } PostConfig;
 
 void
@@ -34,6 +34,34 @@ PostFontGetGlyphMetrics(PostFont*         font,
                         puint32           charCode,
                         PostGlyphMetrics* glyphMetrics);
 
+/** whether the font has a glyph of its own for charCode */
+pbool
+PostFontHasGlyph(PostFont* font, puint32 charCode);
+
+/**
+ * a rendered glyph cut to the cell box it is drawn in, the rows of bitmap are
+ * pitch bytes apart and it is only valid until the font renders again
+ */
+typedef struct
+{
+  puint32       left, top;
+  puint32       width, height;
+  pint32        pitch;
+  const puint8* bitmap;
+} PostGlyphBitmap;
+
+/**
+ * renders charCode on the baseline of a width x height cell box, left and top
+ * place the bitmap in the box and are 0 along with its size when nothing of
+ * the glyph lands inside the box
+ */
+PostError
+PostFontRenderGlyph(PostFont*        font,
+                    puint32          charCode,
+                    puint32          width,
+                    puint32          height,
+                    PostGlyphBitmap* glyph);
+
 PostError
 PostFontLoadGlyph(PostFont* font,
                   puint32   charCode,
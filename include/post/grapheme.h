@@ -0,0 +1,60 @@
+#ifndef POST_GRAPHEME_H
+#define POST_GRAPHEME_H 1
+
+#include "post/graphemetable.h"
+#include "post/types.h"
+
+/**
+ * extended grapheme cluster segmentation (UAX #29), prev is the break class
+ * of the last codepoint, pictographic is set inside Extended_Pictographic
+ * Extend* (ZWJ) and oddRegional after the first of a pair of regional
+ * indicators
+ */
+typedef struct
+{
+  puint8 prev;
+  pbool  pictographic;
+  pbool  oddRegional;
+} PostGraphemeBreaker;
+
+static inline void
+PostGraphemeBreakerReset(PostGraphemeBreaker* breaker, puint8 prev)
+{
+  breaker->prev         = prev;
+  breaker->pictographic = 0;
+  breaker->oddRegional  = 0;
+}
+
+static inline puint8
+PostGraphemeClass(puint32 codepoint)
+{
+  puint32 i;
+
+  if (codepoint > 0x10FFFF)
+    return POST_GRAPHEME_OTHER;
+
+  i = (puint32) postGraphemeIndex[codepoint >> POST_GRAPHEME_SHIFT]
+        << (POST_GRAPHEME_SHIFT - 1) |
+      (codepoint & POST_GRAPHEME_MASK) >> 1;
+
+  return (postGraphemeBlocks[i] >> ((codepoint & 1) << 2)) & 0xF;
+}
+
+pbool
+PostGraphemeBreakLookup(PostGraphemeBreaker* breaker, puint32 codepoint);
+
+/** returns 1 when a cluster boundary comes before codepoint */
+static inline pbool
+PostGraphemeBreak(PostGraphemeBreaker* breaker, puint32 codepoint)
+{
+  // NOTE: ASCII and Latin-1 letters are Other and never continue a cluster,
+  // only the C1 controls, the soft hyphen and (C) (R) need the table
+  if (codepoint < 0x300 && (codepoint < 0x80 || codepoint > 0xAE)) {
+    PostGraphemeBreakerReset(breaker, POST_GRAPHEME_OTHER);
+    return 1;
+  }
+
+  return PostGraphemeBreakLookup(breaker, codepoint);
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef POST_LOG_H
+#define POST_LOG_H 1
+
+#include <stdatomic.h>
+
+#include "post/compiler.h"
+#include "post/error.h"
+#include "post/thread.h"
+#include "post/types.h"
+
+#define POST_LOG_LEVEL_DEBUG   0
+#define POST_LOG_LEVEL_INFO    1
+#define POST_LOG_LEVEL_WARNING 2
+#define POST_LOG_LEVEL_NONE    3
+
+// NOTE: messages below this level are removed at compile time
+#ifndef POST_LOG_MIN_LEVEL
+#define POST_LOG_MIN_LEVEL POST_LOG_LEVEL_INFO
+#endif
+
+// NOTE: must be a power of two
+#define POST_LOG_RING_SIZE    128
+#define POST_LOG_MESSAGE_SIZE 248
+
+// NOTE: each call site may log this many messages per window
+#define POST_LOG_SITE_BURST  8
+#define POST_LOG_SITE_WINDOW 1000000000 // ns
+
+typedef struct PostAppState PostAppState;
+
+/** per call site rate limiter, only touched by the thread that logs */
+typedef struct
+{
+  puint64 windowStart;
+  puint32 count;
+  puint32 suppressed;
+} PostLogSite;
+
+typedef struct
+{
+  _Atomic puint32 sequence;
+  puint8          level;
+  char            message[POST_LOG_MESSAGE_SIZE];
+} PostLogSlot;
+
+/**
+ * bounded lock-free ring of formatted messages, producers claim slots with a
+ * CAS on head and a single background thread drains them into the LogInfo
+ * and LogWarning sinks, a full ring drops messages instead of blocking
+ */
+typedef struct
+{
+  _Atomic puint32 head;
+  puint32         tail;
+  _Atomic puint32 dropped;
+  _Atomic pbool   running;
+  PostThread*     thread;
+  PostEvent*      wake;
+  PostLogSlot     slots[POST_LOG_RING_SIZE];
+} PostLogger;
+
+#define PostAppLog(APP, LEVEL, ...)                                            \
+  do {                                                                         \
+    if ((LEVEL) >= POST_LOG_MIN_LEVEL &&                                       \
+        (LEVEL) >= (APP)->config.logLevel) {                                   \
+      static PostLogSite postLogSite;                                          \
+      PostAppLogWrite((APP), &postLogSite, (LEVEL), __VA_ARGS__);              \
+    }                                                                          \
+  } while (0)
+
+#define PostAppLogDebug(APP, ...)                                              \
+  PostAppLog((APP), POST_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define PostAppLogInfo(APP, ...)                                               \
+  PostAppLog((APP), POST_LOG_LEVEL_INFO, __VA_ARGS__)
+#define PostAppLogWarning(APP, ...)                                            \
+  PostAppLog((APP), POST_LOG_LEVEL_WARNING, __VA_ARGS__)
+
+void
+PostLoggerInit(PostLogger* logger);
+
+/**
+ * starts the drain thread, until then (and after PostAppStopLogging) messages
+ * are delivered synchronously
+ */
+PostError
+PostAppStartLogging(PostAppState* appState);
+
+/**
+ * delivers everything still queued and joins the drain thread, must not race
+ * with threads that are still logging
+ */
+void
+PostAppStopLogging(PostAppState* appState);
+
+PRINTF_FORMAT(4, 5)
+void
+PostAppLogWrite(PostAppState* appState,
+                PostLogSite*  site,
+                puint8        level,
+                const char*   fmt,
+                ...);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef POST_PALETTE_H
+#define POST_PALETTE_H 1
+
+#include "post/color.h"
+#include "post/error.h"
+#include "post/types.h"
+
+#define POST_PALETTE_SIZE 256
+
+/** longest reply of PostPaletteFormatColor ("rgb:rrrr/gggg/bbbb") */
+#define POST_PALETTE_COLOR_SPEC_SIZE 18
+
+/**
+ * the colours colour refs resolve to, OSC 4 rewrites entries and OSC 10 and
+ * 11 the defaults, cells keep their refs so a change shows on the next frame
+ */
+typedef struct
+{
+  PostColor colors[POST_PALETTE_SIZE];
+  PostColor fg, bg;
+} PostPalette;
+
+void
+PostPaletteInit(PostPalette* palette, PostColor fg, PostColor bg);
+
+/**
+ * the xterm colour of index, the 16 ANSI colours followed by the 6x6x6 cube
+ * and the 24 step gray ramp
+ */
+PostColor
+PostPaletteDefaultColor(puint8 index);
+
+/**
+ * parses an X11 colour spec, either "rgb:r/g/b" with 1 to 4 hex digits per
+ * component or "#rgb" with 1 to 4 hex digits per component
+ */
+PostError
+PostPaletteParseColor(const puint8* spec, pusize len, PostColor* color);
+
+/**
+ * writes color as "rgb:rrrr/gggg/bbbb" like xterm does in replies, buf has
+ * room for POST_PALETTE_COLOR_SPEC_SIZE bytes, returns the length
+ */
+pusize
+PostPaletteFormatColor(PostColor color, char* buf);
+
+static inline PostColor
+PostPaletteResolve(const PostPalette* palette,
+                   PostColorRef       ref,
+                   PostColor          defaultColor)
+{
+  switch (PostColorRefTag(ref)) {
+    case POST_COLOR_REF_PALETTE:
+      return palette->colors[ref & 0xFF];
+    case POST_COLOR_REF_RGB:
+      return (PostColor) PostColorRGB(
+        (ref >> 16) & 0xFF, (ref >> 8) & 0xFF, ref & 0xFF);
+    default:
+      return defaultColor;
+  }
+}
+
+#endif
@@ -1,46 +1,79 @@
 #ifndef POST_PARSER_H
 #define POST_PARSER_H 1
 
+#include "post/clipboard.h"
+#include "post/grapheme.h"
 #include "post/string.h"
 #include "post/types.h"
+#include "post/utf8.h"
 
-#define POST_PARSER_STATE_NORMAL       0
-#define POST_PARSER_STATE_ESC          1
-#define POST_PARSER_STATE_DESIGNATE_G0 2
-#define POST_PARSER_STATE_CSI          3
-#define POST_PARSER_STATE_OSC          4
+// NOTE: xterm caps CSI sequences at 30 parameters; extra ones are dropped.
+#define POST_PARSER_MAX_PARAMS 32
+#define POST_PARSER_MAX_PARAM  0xFFFF
+#define POST_PARSER_MAX_INTERMEDIATES 2
+
+// NOTE: an OSC 52 header ("52;Pc;") must fit to be streamed
+#define POST_PARSER_OSC_HEADER_SIZE 16
 
 typedef struct PostCursor   PostCursor;
 typedef struct PostAppState PostAppState;
 
-typedef struct PostAttribute
-{
-  puint32               n;
-  pbool                 isEmpty;
-  struct PostAttribute *prev, *next;
-} PostAttribute;
-
+/**
+ * state follows the DEC VT500 state machine, its transitions are generated at
+ * build time into post/vttable.h
+ */
 typedef struct
 {
-  puint8 state;
-  pbool  isPrivate;
-  union
-  {
-    struct
-    {
-      pbool      parseText;
-      puint8     s;
-      PostString t;
-    };
-    struct
-    {
-      PostAttribute* currentAttrib;
-      PostAttribute* attribs;
-    };
-  };
+  puint8          state;
+  puint8          privateMarker;
+  puint8          numIntermediates;
+  puint8          intermediates[POST_PARSER_MAX_INTERMEDIATES];
+  puint8          numParams;
+  pbool           paramsFull;
+  /**
+   * bit i of subParams is set when params[i] was introduced by ':'
+   * and belongs to the parameter before it, bit i of emptyParams is
+   * set when params[i] had no digits and should take the default
+   */
+  puint32         subParams;
+  puint32         emptyParams;
+  puint16         params[POST_PARSER_MAX_PARAMS];
+  /**
+   * OSC payloads that start and end inside one chunk are used in place
+   * through oscSpan, the rest are copied into osc which is bounded by
+   * config.maxStringSize, stringOverflow discards the rest of the string
+   */
+  PostString      osc;
+  const puint8*   oscSpan;
+  pusize          oscSpanLen;
+  pbool           stringOverflow;
+  /**
+   * set once an OSC 52 header is buffered, the rest of the payload goes
+   * straight to the clipboard transfer instead of osc
+   */
+  pbool                 clipboardStream;
+  PostClipboardTransfer clipboard;
+  PostUTF8Decoder utf8;
+  /**
+   * segmentation state of the last printed codepoint, anything other than
+   * printing resets it so a mark never joins across a control
+   */
+  PostGraphemeBreaker grapheme;
+  /** the last codepoint printed to a cell of its own, repeated by REP */
+  puint32             lastCodepoint;
 } PostParser;
 
 void
-PostParseCSI(PostAppState* appState, PostCursor* cursor, char ch);
+PostParserInit(PostParser* parser);
+
+void
+PostParserFini(PostParser* parser);
+
+/**
+ * runs len bytes through the state machine and returns the number of bytes
+ * consumed, which is always len
+ */
+pusize
+PostParse(PostAppState* appState, const puint8* data, pusize len);
 
 #endif
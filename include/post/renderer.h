@@ -2,6 +2,7 @@
 #define POST_RENDERER_H 1
 
 #include "post/error.h"
+#include "post/string.h"
 #include "post/types.h"
 
 typedef struct PostAppState PostAppState;
@@ -12,6 +13,13 @@ typedef struct PostRenderer
   puint32 cellWidth, cellHeight;
   PostError (*RenderFrame)(PostAppState* appState);
   PostError (*SetWindowTitle)(PostAppState* appState, const char* title);
+  /** selection is 'c' for the clipboard or 'p' for the primary selection */
+  PostError (*SetClipboard)(PostAppState* appState,
+                            puint8        selection,
+                            const char*   text);
+  PostError (*GetClipboard)(PostAppState* appState,
+                            puint8        selection,
+                            PostString*   text);
 } PostRenderer;
 
 void
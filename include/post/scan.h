@@ -0,0 +1,22 @@
+#ifndef POST_SCAN_H
+#define POST_SCAN_H 1
+
+#include "post/types.h"
+
+/**
+ * returns the length of the longest prefix of data made up of printable
+ * ASCII (0x20 - 0x7E), the widest vector unit enabled at compile time is
+ * used with a scalar loop for the tail
+ */
+pusize
+PostScanPrintableASCII(const puint8* data, pusize len);
+
+/**
+ * returns the length of the longest prefix of data that can be string
+ * payload (any byte except C0 controls and DEL), used to take OSC and DCS
+ * strings in bulk
+ */
+pusize
+PostScanStringPayload(const puint8* data, pusize len);
+
+#endif
@@ -0,0 +1,193 @@
+#ifndef POST_SCROLLBACK_H
+#define POST_SCROLLBACK_H 1
+
+#include <stdatomic.h>
+
+#include "post/cell.h"
+#include "post/tempfile.h"
+#include "post/thread.h"
+#include "post/types.h"
+
+/** bytes of a page, its header, the cells and the line offsets included */
+#define POST_SCROLLBACK_PAGE_SIZE (64 << 10)
+
+/** the newest pages are left uncompressed, older ones are packed */
+#define POST_SCROLLBACK_HOT_PAGES 4
+
+// NOTE: must be a power of two
+#define POST_SCROLLBACK_QUEUE_SIZE 64
+
+/** decompressed pages kept around for reading */
+#define POST_SCROLLBACK_CACHE_SIZE 4
+
+typedef struct PostAppState PostAppState;
+
+/**
+ * a fixed size block of lines, cells are packed from the front and the
+ * offset of each line is stored from the back, line i of the page is
+ * cells[offset(i)] up to the start of line i + 1 (or numCells)
+ */
+typedef struct
+{
+  /** sequence number of the first line, see PostScrollback.nextLine */
+  puint64  firstLine;
+  puint32  numLines;
+  puint32  numCells;
+  /**
+   * set while the compression thread has the page, an evicted page is no
+   * longer in the ring and is freed once the thread hands it back
+   */
+  pbool    queued;
+  pbool    evicted;
+  PostCell cells[];
+} PostScrollbackPage;
+
+/**
+ * a compressed page, the line lengths as varints followed by the style and
+ * flag runs and the codepoints as varints, see src/scrollback.c
+ */
+typedef struct
+{
+  puint64 firstLine;
+  puint32 numLines;
+  puint32 numCells;
+  pusize  size;
+  puint8  data[];
+} PostScrollbackPacked;
+
+/** a page of the ring, exactly one of page and packed is set */
+typedef struct
+{
+  PostScrollbackPage*   page;
+  PostScrollbackPacked* packed;
+} PostScrollbackSlot;
+
+typedef struct
+{
+  PostScrollbackPage*   page;
+  PostScrollbackPacked* packed;
+} PostScrollbackResult;
+
+/** where a page dropped from the ring went in the spill file */
+typedef struct
+{
+  puint64 firstLine;
+  puint64 offset;
+  puint32 numLines;
+  puint32 size;
+} PostScrollbackSpilled;
+
+/** buffers for writing pages out and reading them back, see src/scrollback.c */
+typedef struct PostScrollbackSpiller PostScrollbackSpiller;
+
+/**
+ * lines that scrolled off the top of the screen, kept in a ring of at most
+ * maxPages pages, once it is full the oldest page is dropped and reused for
+ * the newest lines so pushing never allocates again
+ *
+ * cells in the scrollback keep the style and cluster references they had on
+ * the screen and give them up when their page is dropped
+ *
+ * pages that fall out of the newest POST_SCROLLBACK_HOT_PAGES are handed to
+ * a background thread through jobs and come back packed through results,
+ * both single producer single consumer rings, the thread only ever reads a
+ * page so nothing on the output path waits for it
+ *
+ * with spill set, pages dropped from the ring are appended to an unlinked
+ * temporary file instead and mapped back in when one of their lines is read,
+ * spilled lines hold no references, their styles and clusters are stored by
+ * value and interned again when the page is read back
+ */
+typedef struct
+{
+  PostScrollbackSlot*  slots;
+  puint32              maxPages, firstPage, numPages;
+  /** sequence number the next pushed line will get */
+  puint64              nextLine;
+  /** lines in the ring and the spill file together */
+  puint64              numLines;
+  /** an empty page kept for the next push instead of freeing it */
+  PostScrollbackPage*  spare;
+
+  PostThread*          thread;
+  PostEvent*           wake;
+  _Atomic pbool        running;
+  PostScrollbackPage*  jobs[POST_SCROLLBACK_QUEUE_SIZE];
+  _Atomic puint32      jobHead;
+  puint32              jobTail;
+  PostScrollbackResult results[POST_SCROLLBACK_QUEUE_SIZE];
+  _Atomic puint32      resultHead;
+  puint32              resultTail;
+  /** pages handed to the thread and not yet taken back */
+  puint32              numQueued;
+
+  /** least recently used pages are decompressed over first */
+  PostScrollbackPage*  cache[POST_SCROLLBACK_CACHE_SIZE];
+  puint64              cacheUse[POST_SCROLLBACK_CACHE_SIZE];
+  puint64              cacheClock;
+  /** set for pages read back from the spill file, they hold references */
+  pbool                cacheOwned[POST_SCROLLBACK_CACHE_SIZE];
+
+  pbool                  spill;
+  PostTempFile*          file;
+  PostScrollbackSpilled* spilled;
+  puint32                numSpilled, maxSpilled;
+  PostScrollbackSpiller* spiller;
+} PostScrollback;
+
+/**
+ * a maxBytes budget below one page turns the scrollback off, it bounds the
+ * memory the scrollback uses, with spill set the history is kept on disk and
+ * only bounded by the space there
+ */
+void
+PostScrollbackInit(PostScrollback* scrollback, pusize maxBytes, pbool spill);
+
+/** stops the compression thread, frees every page and closes the spill file */
+void
+PostScrollbackFini(PostScrollback* scrollback);
+
+/**
+ * appends a row of len cells and takes over their references, a row is
+ * joined onto the line before it when that one wrapped, wrapped says the row
+ * goes on in the next one (or on the top row of the screen), rows longer than
+ * a page holds are cut short
+ */
+void
+PostScrollbackPush(PostAppState*   appState,
+                   const PostCell* cells,
+                   puint32         len,
+                   pbool           wrapped);
+
+/**
+ * takes back the newest line when it wrapped onto the screen, the references
+ * go to the caller and the cells are valid until the next push, returns NULL
+ * when there is no such line
+ */
+const PostCell*
+PostScrollbackPopWrapped(PostAppState* appState, puint32* len);
+
+/** the newest line stops wrapping, for when the row it went on in is gone */
+void
+PostScrollbackEndLine(PostScrollback* scrollback);
+
+/** drops every line, frees the pages and truncates the spill file */
+void
+PostScrollbackClear(PostAppState* appState);
+
+/**
+ * line i counting back from the most recent one (0) to numLines - 1, returns
+ * its cells and sets len and, unless it is NULL, wrapped, a compressed or
+ * spilled page is unpacked into the cache first, the cells are only valid
+ * until the next push or lookup
+ *
+ * lines are kept whole, PostCellWrap splits them at the width they are shown
+ * at so resizing never touches the scrollback
+ */
+const PostCell*
+PostScrollbackLine(PostAppState* appState,
+                   puint64       i,
+                   puint32*      len,
+                   pbool*        wrapped);
+
+#endif
@@ -7,10 +7,10 @@ PostError
 PostSDLAppCreate(PostAppState** appState);
 
 void
-PostSDLAppLogInfo(PostAppState* appState, const char* fmt, va_list args);
+PostSDLAppLogInfo(PostAppState* appState, const char* message);
 
 void
-PostSDLAppLogWarning(PostAppState* appState, const char* fmt, va_list args);
+PostSDLAppLogWarning(PostAppState* appState, const char* message);
 
 void
 PostSDLAppDestroy(PostAppState* appState);
@@ -0,0 +1,111 @@
+#ifndef POST_SDL_ATLAS_H
+#define POST_SDL_ATLAS_H 1
+
+#include <SDL3/SDL.h>
+
+#include "post/error.h"
+#include "post/font.h"
+#include "post/types.h"
+
+/** width and height of a page texture */
+#define POST_SDL_ATLAS_PAGE_SIZE 1024
+
+/** pages kept at once, the least recently used one is reused after that */
+#define POST_SDL_ATLAS_MAX_PAGES 4
+
+#define POST_SDL_ATLAS_MAX_SHELVES 128
+
+#define POST_SDL_ATLAS_NO_PAGE 0xFFFF
+
+/**
+ * a glyph in the atlas, the bitmap cut to its cell box sits at x, y of page
+ * and is drawn at left, top of the cell, an empty glyph (a space) has no page
+ */
+typedef struct
+{
+  puint64 key;
+  puint16 page;
+  puint16 x, y;
+  puint16 width, height;
+  puint16 left, top;
+  /** the font has no glyph of its own for the codepoint */
+  pbool   missing;
+} PostSDLGlyph;
+
+/** a row of glyphs as tall as the tallest one it was opened for */
+typedef struct
+{
+  puint16 y, height, x;
+} PostSDLAtlasShelf;
+
+typedef struct
+{
+  SDL_Texture*      texture;
+  PostSDLAtlasShelf shelves[POST_SDL_ATLAS_MAX_SHELVES];
+  puint32           numShelves;
+  /** frame the page was last drawn from */
+  puint64           lastUse;
+} PostSDLAtlasPage;
+
+/**
+ * glyphs rasterized once and kept in white textures whose alpha is the
+ * coverage, a cell is drawn as one quad tinted with its colour
+ *
+ * glyphs are shelf packed into pages and found through an open addressed map
+ * of (codepoint, face, size, wide), once every page is full the page drawn
+ * from least recently is emptied and packed again
+ */
+typedef struct
+{
+  SDL_Renderer*    sdlRenderer;
+  PostSDLAtlasPage pages[POST_SDL_ATLAS_MAX_PAGES];
+  puint32          numPages;
+  PostSDLGlyph*    glyphs;
+  puint32          numGlyphs, maxGlyphs;
+  /** indices into glyphs plus one, 0 for an empty slot */
+  puint32*         slots;
+  puint32          numSlots;
+  /** one glyph converted to RGBA on its way to a texture */
+  puint8*          staging;
+  puint32          stagingSize;
+  /** advanced by the renderer once a frame to age the pages */
+  puint64          frame;
+  /** called with evictData before a page is emptied to draw what uses it */
+  PostError (*BeforeEvict)(void* evictData);
+  void* evictData;
+} PostSDLAtlas;
+
+void
+PostSDLAtlasInit(PostSDLAtlas* atlas, SDL_Renderer* sdlRenderer);
+
+void
+PostSDLAtlasFini(PostSDLAtlas* atlas);
+
+/**
+ * drops every glyph and page texture, for when the font or its size changes
+ * or the renderer lost its textures
+ */
+void
+PostSDLAtlasClear(PostSDLAtlas* atlas);
+
+/**
+ * the glyph of codepoint cut to a width x height cell box, face tells apart
+ * the fonts drawn at once (bold, italic) and is below 256, the glyph is
+ * rasterized and packed on first use and only valid until the next lookup
+ */
+PostError
+PostSDLAtlasGet(PostSDLAtlas*        atlas,
+                PostFont*            font,
+                puint32              face,
+                puint32              codepoint,
+                puint32              width,
+                puint32              height,
+                const PostSDLGlyph** glyph);
+
+static inline SDL_Texture*
+PostSDLAtlasTexture(const PostSDLAtlas* atlas, const PostSDLGlyph* glyph)
+{
+  return atlas->pages[glyph->page].texture;
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef POST_SDL_BATCH_H
+#define POST_SDL_BATCH_H 1
+
+#include <SDL3/SDL.h>
+
+#include "post/color.h"
+#include "post/error.h"
+#include "post/types.h"
+
+#include "post/sdl/atlas.h"
+
+/** fills drawn before the glyphs, the cell backgrounds */
+#define POST_SDL_BATCH_UNDER 0
+
+/** glyphs packed into atlas page PAGE */
+#define PostSDLBatchPage(PAGE) ((PAGE) + 1)
+
+/** fills drawn over the glyphs, the decorations and the cursor */
+#define POST_SDL_BATCH_OVER (POST_SDL_ATLAS_MAX_PAGES + 1)
+
+#define POST_SDL_BATCH_LAYERS (POST_SDL_ATLAS_MAX_PAGES + 2)
+
+typedef struct
+{
+  int*    indices;
+  puint32 numIndices, maxIndices;
+} PostSDLBatchLayer;
+
+/**
+ * the quads of a frame in one vertex buffer, each layer indexes the quads
+ * drawn with one texture so a frame is a SDL_RenderGeometry call per layer
+ * in use, fills use no texture and glyphs the atlas page they are packed in
+ */
+typedef struct
+{
+  SDL_Vertex*       vertices;
+  puint32           numVertices, maxVertices;
+  PostSDLBatchLayer layers[POST_SDL_BATCH_LAYERS];
+} PostSDLBatch;
+
+void
+PostSDLBatchInit(PostSDLBatch* batch);
+
+void
+PostSDLBatchFini(PostSDLBatch* batch);
+
+/** a rectangle of color in layer, under or over the glyphs */
+PostError
+PostSDLBatchFill(PostSDLBatch* batch,
+                 puint32       layer,
+                 float         x,
+                 float         y,
+                 float         width,
+                 float         height,
+                 PostColor     color);
+
+/** glyph at x, y of its cell tinted with color */
+PostError
+PostSDLBatchGlyph(PostSDLBatch*       batch,
+                  const PostSDLGlyph* glyph,
+                  float               x,
+                  float               y,
+                  PostColor           color);
+
+/**
+ * draws the layers in order and empties the batch, the glyphs are clipped to
+ * their cells so a batch submitted part way through a frame draws the same
+ */
+PostError
+PostSDLBatchSubmit(PostSDLBatch* batch,
+                   SDL_Renderer* sdlRenderer,
+                   PostSDLAtlas* atlas);
+
+#endif
@@ -4,16 +4,35 @@
 #include <SDL3/SDL.h>
 
 #include "post/font.h"
+#include "post/palette.h"
 #include "post/renderer.h"
 #include "post/types.h"
 
+#include "post/sdl/atlas.h"
+#include "post/sdl/batch.h"
+#include "post/sdl/rowcache.h"
+
 typedef struct
 {
-  PostRenderer  base;
-  SDL_Window*   sdlWindow;
-  SDL_Renderer* sdlRenderer;
-  PostFont      activeFont;
-  puint8*       glyphBitmap;
+  PostRenderer    base;
+  SDL_Window*     sdlWindow;
+  SDL_Renderer*   sdlRenderer;
+  PostFont        activeFont;
+  PostSDLAtlas    atlas;
+  PostSDLBatch    batch;
+  PostSDLRowCache rowCache;
+  /** the grid as last drawn, only its damaged rows are drawn again */
+  SDL_Texture*    target;
+  /** what target is copied into when the grid scrolls, the two then swap */
+  SDL_Texture*    backTarget;
+  puint32         targetWidth, targetHeight;
+  /** the palette target was drawn with */
+  PostPalette     drawnPalette;
+  /** set when target lost what it held and the grid is drawn again whole */
+  pbool           redraw;
+  /** where the cursor was last put on screen */
+  pbool           cursorVisible;
+  puint32         cursorX, cursorY;
 } PostSDLRenderer;
 
 PostError
@@ -22,6 +41,24 @@ PostSDLSetCellSize(PostSDLRenderer* renderer);
 PostError
 PostSDLSetTitle(PostAppState* appState, const char* title);
 
+PostError
+PostSDLSetClipboard(PostAppState* appState, puint8 selection, const char* text);
+
+PostError
+PostSDLGetClipboard(PostAppState* appState, puint8 selection, PostString* text);
+
+/** submits the batched quads, the atlas calls it before reusing a page */
+PostError
+PostSDLFlushBatch(void* renderer);
+
+/** draws the whole grid on the next frame, after the window was exposed */
+void
+PostSDLRedraw(PostAppState* appState);
+
+/** drops every texture drawn into, after the renderer lost its device */
+void
+PostSDLResetDevice(PostAppState* appState);
+
 PostError
 PostSDLRenderFrame(PostAppState* appState);
 
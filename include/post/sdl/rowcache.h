@@ -0,0 +1,90 @@
+#ifndef POST_SDL_ROWCACHE_H
+#define POST_SDL_ROWCACHE_H 1
+
+#include <SDL3/SDL.h>
+
+#include "post/error.h"
+#include "post/types.h"
+
+/** height of a texture the cached rows are stacked in */
+#define POST_SDL_ROW_CACHE_TEXTURE_HEIGHT 2048
+
+#define POST_SDL_ROW_CACHE_MAX_SLOTS 65536
+
+#define POST_SDL_ROW_HASH_SEED  0xCBF29CE484222325ull
+#define POST_SDL_ROW_HASH_PRIME 0x100000001B3ull
+
+/** folds value into the hash of a row, FNV-1a over whole values */
+static inline puint64
+PostSDLRowHash(puint64 hash, puint64 value)
+{
+  return (hash ^ value) * POST_SDL_ROW_HASH_PRIME;
+}
+
+/** a row drawn this frame to be copied into the cache once it is submitted */
+typedef struct
+{
+  puint64 hash;
+  float   y;
+} PostSDLRowCacheStore;
+
+/**
+ * rows drawn before kept in textures and keyed by a hash of their cells, a
+ * row that hashes the same as one cached is copied from the cache instead of
+ * being built again
+ *
+ * the slots are as large as a row of the grid and as many as fit the budget,
+ * once they are all in use the least recently drawn one is reused, map is
+ * an open addressed map of hashes to slot indices plus one
+ */
+typedef struct
+{
+  SDL_Renderer*         sdlRenderer;
+  pusize                budget;
+  SDL_Texture**         textures;
+  puint32               numTextures, rowsPerTexture;
+  puint32               rowWidth, rowHeight;
+  puint32               numSlots, usedSlots;
+  puint64*              slotHashes;
+  puint64*              slotUses;
+  puint32*              map;
+  puint32               mapSize;
+  PostSDLRowCacheStore* stores;
+  puint32               numStores, maxStores;
+  puint64               uses;
+  /** rows copied from the cache and rows that had to be built */
+  puint64               hits, misses;
+} PostSDLRowCache;
+
+/** budget is the most bytes of textures the cache holds, 0 turns it off */
+void
+PostSDLRowCacheInit(PostSDLRowCache* cache,
+                    SDL_Renderer*    sdlRenderer,
+                    pusize           budget);
+
+void
+PostSDLRowCacheFini(PostSDLRowCache* cache);
+
+/**
+ * drops every row and makes the slots width x height pixels, a cache reset
+ * to 0 x 0 holds no textures and never fails
+ */
+PostError
+PostSDLRowCacheReset(PostSDLRowCache* cache, puint32 width, puint32 height);
+
+/**
+ * copies the row cached under hash to y of the render target and counts a
+ * hit, or counts a miss and returns 0 when there is none
+ */
+pbool
+PostSDLRowCacheDraw(PostSDLRowCache* cache, puint64 hash, float y);
+
+/** the row at y of the target is to be cached under hash once it is drawn */
+PostError
+PostSDLRowCacheDefer(PostSDLRowCache* cache, puint64 hash, float y);
+
+/** copies the deferred rows out of target, which has been drawn in full */
+PostError
+PostSDLRowCacheStoreRows(PostSDLRowCache* cache, SDL_Texture* target);
+
+#endif
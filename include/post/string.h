@@ -15,6 +15,13 @@ typedef struct
 PostError
 PostStringAppendChar(PostString* str, char c);
 
+PostError
+PostStringAppend(PostString* str, const char* data, pusize len);
+
+/** grows the buffer so it holds at least cap bytes */
+PostError
+PostStringReserve(PostString* str, pusize cap);
+
 void
 PostStringRelease(PostString* str);
 
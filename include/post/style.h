@@ -0,0 +1,91 @@
+#ifndef POST_STYLE_H
+#define POST_STYLE_H 1
+
+#include "post/color.h"
+#include "post/error.h"
+#include "post/types.h"
+
+/** id 0 is the default style, it is never stored and never freed */
+#define POST_STYLE_DEFAULT 0
+#define POST_STYLE_NONE    0xFFFF
+#define POST_STYLE_BUCKETS 4096
+
+/** ul is the underline colour, by default it follows fg */
+typedef struct
+{
+  PostColorRef fg, bg, ul;
+  puint16      sgr;
+} PostStyle;
+
+/**
+ * next chains entries in the same hash bucket while the entry is live and
+ * links the free list once it is not
+ */
+typedef struct
+{
+  PostStyle style;
+  puint32   refs;
+  puint16   next;
+} PostStyleEntry;
+
+/**
+ * every distinct style in use, cells and the cursor refer to an entry by a
+ * 16-bit id and hold one reference each
+ */
+typedef struct
+{
+  PostStyle       defaultStyle;
+  PostStyleEntry* entries;
+  puint32         numEntries, maxEntries;
+  puint16         freeEntry;
+  /** live entries other than the default */
+  puint32         numLive;
+  puint16         buckets[POST_STYLE_BUCKETS];
+} PostStyleTable;
+
+void
+PostStyleTableInit(PostStyleTable* table, const PostStyle* defaultStyle);
+
+void
+PostStyleTableFini(PostStyleTable* table);
+
+/**
+ * finds or adds style and returns its id in id with a reference taken, the
+ * table holds at most 0xFFFE styles
+ */
+PostError
+PostStyleIntern(PostStyleTable* table, const PostStyle* style, puint16* id);
+
+void
+PostStyleFree(PostStyleTable* table, puint16 id);
+
+static inline pbool
+PostStyleEqual(const PostStyle* a, const PostStyle* b)
+{
+  return a->fg == b->fg && a->bg == b->bg && a->ul == b->ul &&
+         a->sgr == b->sgr;
+}
+
+static inline void
+PostStyleRetain(PostStyleTable* table, puint16 id, puint32 n)
+{
+  if (id != POST_STYLE_DEFAULT)
+    table->entries[id].refs += n;
+}
+
+static inline void
+PostStyleRelease(PostStyleTable* table, puint16 id, puint32 n)
+{
+  if (id != POST_STYLE_DEFAULT && !(table->entries[id].refs -= n))
+    PostStyleFree(table, id);
+}
+
+static inline const PostStyle*
+PostStyleGet(const PostStyleTable* table, puint16 id)
+{
+  if (id == POST_STYLE_DEFAULT)
+    return &table->defaultStyle;
+  return &table->entries[id].style;
+}
+
+#endif
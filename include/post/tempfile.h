@@ -0,0 +1,48 @@
+#ifndef POST_TEMPFILE_H
+#define POST_TEMPFILE_H 1
+
+#include "post/error.h"
+#include "post/types.h"
+
+/**
+ * an append only file that is unlinked as soon as it is created, it has no
+ * name and goes away with the last descriptor, also when the process dies
+ */
+typedef struct PostTempFile PostTempFile;
+
+/** a read only mapping of part of a PostTempFile, data is the mapped range */
+typedef struct
+{
+  void*         base;
+  pusize        length;
+  const puint8* data;
+} PostTempFileView;
+
+/** creates the file in $TMPDIR, or /tmp when that is not set */
+PostError
+PostTempFileCreate(PostTempFile** file);
+
+void
+PostTempFileDestroy(PostTempFile* file);
+
+/** writes size bytes to the end of the file and sets offset to their start */
+PostError
+PostTempFileAppend(PostTempFile* file,
+                   const void*   data,
+                   pusize        size,
+                   puint64*      offset);
+
+/**
+ * maps size bytes at offset, the pages are only read in from the file (or the
+ * page cache) when they are touched
+ */
+PostError
+PostTempFileMap(PostTempFile*     file,
+                puint64           offset,
+                pusize            size,
+                PostTempFileView* view);
+
+void
+PostTempFileUnmap(PostTempFileView* view);
+
+#endif
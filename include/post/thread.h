@@ -0,0 +1,36 @@
+#ifndef POST_THREAD_H
+#define POST_THREAD_H 1
+
+#include "post/error.h"
+#include "post/types.h"
+
+typedef struct PostThread PostThread;
+
+/** a counting wakeup, Signal never blocks and is safe from any thread */
+typedef struct PostEvent PostEvent;
+
+typedef void (*PostThreadFunc)(void* arg);
+
+PostError
+PostThreadCreate(PostThread** thread, PostThreadFunc func, void* arg);
+
+void
+PostThreadJoin(PostThread* thread);
+
+PostError
+PostEventCreate(PostEvent** event);
+
+void
+PostEventDestroy(PostEvent* event);
+
+void
+PostEventSignal(PostEvent* event);
+
+void
+PostEventWait(PostEvent* event);
+
+/** monotonic clock in nanoseconds */
+puint64
+PostTimeNanos(void);
+
+#endif
@@ -10,9 +10,13 @@
 #define POST_UNICODE_VT            0xB  // Vertical Tabulation
 #define POST_UNICODE_FF            0xC  // Form Feed
 #define POST_UNICODE_CR            0xD  // Carriage Return
+#define POST_UNICODE_CAN           0x18 // Cancel
 #define POST_UNICODE_SUB           0x1A // Substitute
 #define POST_UNICODE_ESC           0x1B // Escape
+#define POST_UNICODE_SPACE         0x20
+#define POST_UNICODE_NUMBER_SIGN   0x23
 #define POST_UNICODE_LPAREN        0x28
+#define POST_UNICODE_SLASH         0x2F
 #define POST_UNICODE_0             0x30
 #define POST_UNICODE_1             0x31
 #define POST_UNICODE_2             0x32
@@ -23,7 +27,9 @@
 #define POST_UNICODE_7             0x37
 #define POST_UNICODE_8             0x38
 #define POST_UNICODE_9             0x39
+#define POST_UNICODE_COLON         0x3A
 #define POST_UNICODE_SEMICOLON     0x3B
+#define POST_UNICODE_LESS_THAN     0x3C
 #define POST_UNICODE_QUESTION_MARK 0x3F
 #define POST_UNICODE_AT_SIGN       0x40
 #define POST_UNICODE_A             0x41
@@ -39,8 +45,15 @@
 #define POST_UNICODE_K             0x4B
 #define POST_UNICODE_L             0x4C
 #define POST_UNICODE_M             0x4D
+#define POST_UNICODE_P             0x50
+#define POST_UNICODE_S             0x53
+#define POST_UNICODE_T             0x54
+#define POST_UNICODE_X             0x58
+#define POST_UNICODE_Z             0x5A
 #define POST_UNICODE_LBRACK        0x5B
+#define POST_UNICODE_BACKSLASH     0x5C
 #define POST_UNICODE_RBRACK        0x5D
+#define POST_UNICODE_GRAVE         0x60
 #define POST_UNICODE_a             0x61
 #define POST_UNICODE_b             0x62
 #define POST_UNICODE_c             0x63
@@ -54,5 +67,11 @@
 #define POST_UNICODE_k             0x6B
 #define POST_UNICODE_l             0x6C
 #define POST_UNICODE_m             0x6D
+#define POST_UNICODE_p             0x70
+#define POST_UNICODE_r             0x72
+#define POST_UNICODE_s             0x73
+#define POST_UNICODE_u             0x75
+#define POST_UNICODE_TILDE         0x7E
+#define POST_UNICODE_DEL           0x7F // Delete
 
 #endif
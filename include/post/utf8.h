@@ -0,0 +1,50 @@
+#ifndef POST_UTF8_H
+#define POST_UTF8_H 1
+
+#include "post/types.h"
+
+#define POST_UTF8_REPLACEMENT 0xFFFD
+
+/**
+ * a partially decoded sequence, kept between reads so a codepoint may be
+ * split across buffers
+ */
+typedef struct
+{
+  puint32 codepoint;
+  puint8  needed, seen;
+  puint8  lower, upper;
+} PostUTF8Decoder;
+
+static inline void
+PostUTF8DecoderReset(PostUTF8Decoder* decoder)
+{
+  decoder->codepoint = 0;
+  decoder->needed    = 0;
+  decoder->seen      = 0;
+  decoder->lower     = 0x80;
+  decoder->upper     = 0xBF;
+}
+
+static inline pbool
+PostUTF8DecoderIsIdle(const PostUTF8Decoder* decoder)
+{
+  return !decoder->needed;
+}
+
+/**
+ * decodes the non-ASCII run at the start of data into at most maxOut
+ * codepoints and returns the number of bytes consumed, decoding stops before
+ * the first ASCII byte that does not belong to a sequence. Invalid input is
+ * replaced with U+FFFD one maximal subpart at a time, a sequence cut short by
+ * the end of data is kept in the decoder for the next call.
+ */
+pusize
+PostUTF8Decode(PostUTF8Decoder* decoder,
+               const puint8*    data,
+               pusize           len,
+               puint32*         out,
+               pusize           maxOut,
+               pusize*          numOut);
+
+#endif
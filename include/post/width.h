@@ -0,0 +1,29 @@
+#ifndef POST_WIDTH_H
+#define POST_WIDTH_H 1
+
+#include "post/types.h"
+#include "post/widthtable.h"
+
+/**
+ * number of columns codepoint occupies (0, 1 or 2), the caller handles
+ * controls so ASCII never reaches the table
+ */
+static inline puint8
+PostCodepointWidth(puint32 codepoint)
+{
+  puint32 i;
+
+  if (codepoint < 0x7F)
+    return 1;
+
+  if (codepoint > 0x10FFFF)
+    return 1;
+
+  i = (puint32) postWidthIndex[codepoint >> POST_WIDTH_SHIFT]
+        << (POST_WIDTH_SHIFT - 2) |
+      (codepoint & POST_WIDTH_MASK) >> 2;
+
+  return (postWidthBlocks[i] >> ((codepoint & 3) << 1)) & 3;
+}
+
+#endif
@@ -24,230 +24,975 @@
 
 #include "post.h"
 #include "post/parser.h"
-#include "post/string.h"
 #include "post/unicode.h"
+#include "post/width.h"
 
-static puint32
-PostAppAdvanceY(PostCellGrid grid, puint32 y)
+static void
+PostAppClearRows(PostAppState* appState, puint32 top, puint32 n)
+{
+  for (puint32 y = top; y < top + n; ++y)
+    PostAppEraseCells(appState, y, 0, appState->grid.width);
+}
+
+/** frees the arrays of grid, releasing its cells first when release is set */
+static void
+PostAppFreeGrid(PostAppState* appState, PostCellGrid* grid, pbool release)
 {
-  if (++y == grid.height) {
-    puint32 width = grid.width;
-    y             = grid.height - 1;
-    memmove(grid.cells, grid.cells + width, width * y * sizeof(PostCell));
-    memset(grid.cells + width * y, 0, grid.width * sizeof(PostCell));
+  if (release && grid->cells != NULL)
+    for (puint32 y = 0; y < grid->height; ++y)
+      PostAppReleaseCells(
+        appState, PostGridRow(grid, y), *PostGridBlankFrom(grid, y));
+
+  free(grid->cells);
+  free(grid->rows);
+  free(grid->blankFrom);
+  free(grid->wrapped);
+  free(grid->damage);
+
+  *grid = (PostCellGrid) { 0 };
+}
+
+/** a blank width x height grid */
+static PostError
+PostAppAllocGrid(PostCellGrid* grid, puint32 width, puint32 height)
+{
+  *grid = (PostCellGrid) {
+    .byteSize  = (pusize) width * height * sizeof(PostCell),
+    .width     = width,
+    .height    = height,
+    .cells     = malloc((pusize) width * height * sizeof(PostCell)),
+    .rows      = malloc(height * sizeof(*grid->rows)),
+    .blankFrom = calloc(height, sizeof(*grid->blankFrom)),
+    .wrapped   = calloc(height, sizeof(*grid->wrapped)),
+    .damage    = calloc(height, sizeof(*grid->damage)),
+  };
+
+  if (grid->cells == NULL || grid->rows == NULL || grid->blankFrom == NULL ||
+      grid->wrapped == NULL || grid->damage == NULL) {
+    free(grid->cells);
+    free(grid->rows);
+    free(grid->blankFrom);
+    free(grid->wrapped);
+    free(grid->damage);
+    *grid = (PostCellGrid) { 0 };
+
+    return POST_ERR_OUT_OF_MEMORY;
   }
 
+  for (puint32 y = 0; y < height; ++y)
+    grid->rows[y] = y;
+
+  return POST_ERR_NONE;
+}
+
+/** reverses the order of rows top to bottom (inclusive) */
+static void
+PostAppReverseRows(PostCellGrid* grid, puint32 top, puint32 bottom)
+{
+  for (; top < bottom; ++top, --bottom) {
+    puint32* a   = PostGridRowSlot(grid, top);
+    puint32* b   = PostGridRowSlot(grid, bottom);
+    puint32  tmp = *a;
+
+    *a = *b;
+    *b = tmp;
+  }
+}
+
+/**
+ * logs rows top to bottom (inclusive) scrolling up by delta rows, or down
+ * when it is negative, and moves their damage along with them
+ */
+static void
+PostAppDamageScroll(PostCellGrid* grid,
+                    puint32       top,
+                    puint32       bottom,
+                    pint32        delta)
+{
+  PostGridScroll* last = grid->scrolls + grid->numScrolls - 1;
+  puint32         rows = bottom - top + 1;
+  puint32         n    = delta < 0 ? -delta : delta;
+
+  // NOTE: scrolls of the same region add up, as one line feed after another
+  // at the bottom of the screen does
+  if (grid->numScrolls && last->top == top && last->bottom == bottom) {
+    last->delta += delta;
+
+    if (last->delta > (pint32) rows)
+      last->delta = rows;
+    else if (last->delta < -(pint32) rows)
+      last->delta = -(pint32) rows;
+  } else if (grid->numScrolls < POST_GRID_MAX_SCROLLS)
+    grid->scrolls[grid->numScrolls++] =
+      (PostGridScroll) { .top = top, .bottom = bottom, .delta = delta };
+  else {
+    PostGridDamageRows(grid, top, bottom);
+    return;
+  }
+
+  if (delta > 0)
+    memmove(grid->damage + top,
+            grid->damage + top + n,
+            (rows - n) * sizeof(PostRowDamage));
+  else
+    memmove(grid->damage + top + n,
+            grid->damage + top,
+            (rows - n) * sizeof(PostRowDamage));
+
+  for (puint32 y = 0; y < n; ++y)
+    grid->damage[delta > 0 ? bottom - y : top + y] =
+      (PostRowDamage) { .start = 0, .end = grid->width };
+}
+
+static puint32
+PostAppAdvanceY(PostAppState* appState, puint32 y)
+{
+  if (y == appState->scrollBottom)
+    PostAppScrollUp(appState, appState->scrollTop, y, 1);
+  else if (y + 1 < appState->grid.height)
+    ++y;
+
   return y;
 }
 
+/** moves on to the next row after the last column was written */
+static void
+PostAppWrap(PostAppState* appState, PostCursor* cursor)
+{
+  *PostGridWrapped(&appState->grid, cursor->y) = 1;
+
+  cursor->lastColumnFlag = 0;
+  cursor->x              = 0;
+  cursor->y              = PostAppAdvanceY(appState, cursor->y);
+}
+
 static void
-PostAppAdvance(PostCellGrid grid, PostCursor* cursor)
+PostAppAdvance(PostAppState* appState, PostCursor* cursor)
+{
+  if (++cursor->x == appState->grid.width) {
+    if (cursor->lastColumnFlag)
+      PostAppWrap(appState, cursor);
+    else {
+      cursor->lastColumnFlag = 1;
+      cursor->x              = appState->grid.width - 1;
+    }
+  }
+}
+
+void
+PostAppWriteASCII(PostAppState* appState,
+                  PostCursor*   cursor,
+                  const puint8* run,
+                  pusize        len)
+{
+  PostCellGrid* grid = &appState->grid;
+  PostCell      cell = { .style = cursor->style };
+
+  while (len) {
+    PostCell* cells;
+    puint32   n;
+
+    if (cursor->lastColumnFlag)
+      PostAppWrap(appState, cursor);
+
+    n = grid->width - cursor->x;
+    if (n > len)
+      n = len;
+
+    PostAppSplitWide(appState, cursor->y, cursor->x, cursor->x + n);
+
+    cells = PostGridRowWrite(grid, cursor->y, cursor->x + n) + cursor->x;
+    PostAppReleaseCells(appState, cells, n);
+    PostGridDamage(grid, cursor->y, cursor->x, cursor->x + n);
+
+    for (puint32 i = 0; i < n; ++i) {
+      cell.charCode = run[i];
+      cells[i]      = cell;
+    }
+
+    PostStyleRetain(&appState->styles, cell.style, n);
+
+    run += n;
+    len -= n;
+
+    if ((cursor->x += n) == grid->width) {
+      cursor->lastColumnFlag = 1;
+      cursor->x              = grid->width - 1;
+    }
+  }
+}
+
+void
+PostAppWriteCodepoints(PostAppState*  appState,
+                       PostCursor*    cursor,
+                       const puint32* codepoints,
+                       pusize         len)
+{
+  PostCellGrid* grid = &appState->grid;
+  PostCell      cell = { .style = cursor->style };
+
+  for (pusize i = 0; i < len; ++i) {
+    PostCell* cells;
+    puint8    width = PostCodepointWidth(codepoints[i]);
+
+    // NOTE: zero width codepoints have no cell of their own to go into
+    if (!width)
+      continue;
+
+    if (width == 2 && grid->width < 2)
+      width = 1;
+
+    if (cursor->lastColumnFlag)
+      PostAppWrap(appState, cursor);
+
+    // NOTE: a wide character never straddles rows, the last column is blanked
+    // and the character wraps like xterm does
+    if (width == 2 && cursor->x + 1 == grid->width) {
+      PostAppSplitWide(appState, cursor->y, cursor->x, grid->width);
+      cells = PostGridRowWrite(grid, cursor->y, grid->width) + cursor->x;
+      PostAppReleaseCells(appState, cells, 1);
+      PostGridDamage(grid, cursor->y, cursor->x, grid->width);
+      PostStyleRetain(&appState->styles, cell.style, 1);
+      *cells = cell;
+
+      PostAppWrap(appState, cursor);
+    }
+
+    PostAppSplitWide(appState, cursor->y, cursor->x, cursor->x + width);
+
+    cells = PostGridRowWrite(grid, cursor->y, cursor->x + width) + cursor->x;
+    PostAppReleaseCells(appState, cells, width);
+    PostGridDamage(grid, cursor->y, cursor->x, cursor->x + width);
+    PostStyleRetain(&appState->styles, cell.style, width);
+
+    cells[0]          = cell;
+    cells[0].charCode = codepoints[i];
+
+    if (width == 2) {
+      cells[0].flags = POST_CELL_WIDE;
+      cells[1]       = cell;
+      cells[1].flags = POST_CELL_WIDE_SPACER;
+    }
+
+    if ((cursor->x += width) == grid->width) {
+      cursor->lastColumnFlag = 1;
+      cursor->x              = grid->width - 1;
+    }
+  }
+}
+
+void
+PostAppExtendCluster(PostAppState* appState,
+                     PostCursor*   cursor,
+                     puint32       codepoint)
+{
+  PostCellGrid* grid = &appState->grid;
+  PostCell*     cell;
+  puint32       x = cursor->x;
+  PostError     error;
+
+  if (!cursor->lastColumnFlag) {
+    if (!x)
+      return;
+    --x;
+  }
+
+  if (x >= *PostGridBlankFrom(grid, cursor->y))
+    return;
+
+  cell = PostGridRow(grid, cursor->y) + x;
+
+  if (cell->flags & POST_CELL_WIDE_SPACER && x) {
+    --cell;
+    --x;
+  }
+
+  if (!cell->charCode)
+    return;
+
+  PostGridDamage(
+    grid, cursor->y, x, cell->flags & POST_CELL_WIDE ? x + 2 : x + 1);
+
+  error = PostClusterExtend(&appState->clusters, &cell->charCode, codepoint);
+
+  if (error != POST_ERR_NONE)
+    PostAppLogWarning(
+      appState, "Failed to Extend Cluster: %s", PostErrorString(error));
+}
+
+void
+PostAppEraseCells(PostAppState* appState,
+                  puint32       y,
+                  puint32       start,
+                  puint32       end)
+{
+  PostCell* row       = PostGridRow(&appState->grid, y);
+  puint32*  blankFrom = PostGridBlankFrom(&appState->grid, y);
+
+  if (end >= appState->grid.width)
+    *PostGridWrapped(&appState->grid, y) = 0;
+
+  if (start >= *blankFrom)
+    return;
+
+  // NOTE: a wide character loses both halves when one of them is erased
+  PostAppSplitWide(appState, y, start, end);
+  PostGridDamage(
+    &appState->grid, y, start, end < *blankFrom ? end : *blankFrom);
+
+  // NOTE: the top row may be where the newest line of the scrollback went on,
+  // once it is erased that line ends there
+  if (!y && !start && end >= appState->grid.width && !appState->altScreen)
+    PostScrollbackEndLine(&appState->scrollback);
+
+  if (end >= *blankFrom) {
+    PostAppReleaseCells(appState, row + start, *blankFrom - start);
+    *blankFrom = start;
+    return;
+  }
+
+  PostAppReleaseCells(appState, row + start, end - start);
+  memset(row + start, 0, (end - start) * sizeof(PostCell));
+}
+
+void
+PostAppUpdateStyle(PostAppState* appState, PostCursor* cursor)
+{
+  PostStyleTable* styles = &appState->styles;
+  puint16         style;
+  PostError       error;
+
+  if (PostStyleEqual(&cursor->attrs, PostStyleGet(styles, cursor->style)))
+    return;
+
+  error = PostStyleIntern(styles, &cursor->attrs, &style);
+
+  // NOTE: with the table full the text is written in the default style
+  if (error != POST_ERR_NONE) {
+    PostAppLogWarning(
+      appState, "Failed to Intern Style: %s", PostErrorString(error));
+    style = POST_STYLE_DEFAULT;
+  }
+
+  PostStyleRelease(styles, cursor->style, 1);
+  cursor->style = style;
+}
+
+void
+PostAppExecute(PostAppState* appState, PostCursor* cursor, puint8 ch)
 {
-  if (++cursor->x == grid.width) {
-    if (cursor->lastColumnFlag) {
+  switch (ch) {
+    case POST_UNICODE_BS:
+      cursor->lastColumnFlag = 0;
+      if (cursor->x)
+        --cursor->x;
+      else if (cursor->y) {
+        cursor->x = appState->grid.width - 1;
+        --cursor->y;
+      }
+      break;
+    case POST_UNICODE_HT:
+      cursor->lastColumnFlag = 0;
+      for (int i = 0; i < appState->config.tabWidth; ++i)
+        PostAppAdvance(appState, cursor);
+      break;
+    case POST_UNICODE_LF:
+    case POST_UNICODE_VT:
+    case POST_UNICODE_FF:
+      PostAppNextLine(appState, cursor);
+      break;
+    case POST_UNICODE_CR:
       cursor->lastColumnFlag = 0;
       cursor->x              = 0;
-      cursor->y              = PostAppAdvanceY(grid, cursor->y);
-    } else {
-      cursor->lastColumnFlag = 1;
-      cursor->x              = grid.width - 1;
+      break;
+    default:
+      // NOTE: the remaining C0 controls are ignored
+      break;
+  }
+}
+
+void
+PostAppNextLine(PostAppState* appState, PostCursor* cursor)
+{
+  cursor->lastColumnFlag = 0;
+  cursor->x              = 0;
+  cursor->y              = PostAppAdvanceY(appState, cursor->y);
+}
+
+void
+PostAppIndex(PostAppState* appState, PostCursor* cursor)
+{
+  cursor->lastColumnFlag = 0;
+  cursor->y              = PostAppAdvanceY(appState, cursor->y);
+}
+
+void
+PostAppReverseIndex(PostAppState* appState, PostCursor* cursor)
+{
+  cursor->lastColumnFlag = 0;
+
+  if (cursor->y == appState->scrollTop)
+    PostAppScrollDown(
+      appState, appState->scrollTop, appState->scrollBottom, 1);
+  else if (cursor->y)
+    --cursor->y;
+}
+
+void
+PostAppScrollUp(PostAppState* appState,
+                puint32       top,
+                puint32       bottom,
+                puint32       n)
+{
+  PostCellGrid* grid = &appState->grid;
+
+  if (top > bottom || bottom >= grid->height)
+    return;
+
+  if (n > bottom - top + 1)
+    n = bottom - top + 1;
+
+  if (!n)
+    return;
+
+  // NOTE: rows scrolled off the top of the screen move to the scrollback
+  // along with their references, which leaves them blank, the alternate
+  // screen has no scrollback and its rows are only cleared
+  if (!top && !appState->altScreen)
+    for (puint32 y = 0; y < n; ++y) {
+      puint32* blankFrom = PostGridBlankFrom(grid, y);
+
+      PostScrollbackPush(appState,
+                         PostGridRow(grid, y),
+                         *blankFrom,
+                         *PostGridWrapped(grid, y));
+      *blankFrom = 0;
     }
+  else if (top)
+    *PostGridWrapped(grid, top - 1) = 0;
+
+  PostAppClearRows(appState, top, n);
+  PostAppDamageScroll(grid, top, bottom, n);
+
+  // NOTE: the cleared rows are rotated to the bottom, for the whole screen
+  // that is just moving the head of the ring
+  if (!top && bottom == grid->height - 1) {
+    if ((grid->head += n) >= grid->height)
+      grid->head -= grid->height;
+  } else {
+    PostAppReverseRows(grid, top, top + n - 1);
+    PostAppReverseRows(grid, top + n, bottom);
+    PostAppReverseRows(grid, top, bottom);
   }
+
+  PostClusterTableTrim(&appState->clusters);
 }
 
 void
-PostAppWriteASCIIString(PostAppState* appState, const char* str)
+PostAppScrollDown(PostAppState* appState,
+                  puint32       top,
+                  puint32       bottom,
+                  puint32       n)
+{
+  PostCellGrid* grid = &appState->grid;
+
+  if (top > bottom || bottom >= grid->height)
+    return;
+
+  if (n > bottom - top + 1)
+    n = bottom - top + 1;
+
+  if (!n)
+    return;
+
+  if (top)
+    *PostGridWrapped(grid, top - 1) = 0;
+  else if (!appState->altScreen)
+    PostScrollbackEndLine(&appState->scrollback);
+
+  // NOTE: the row that ends up at the bottom went on in a row that is gone
+  if (n <= bottom - top)
+    *PostGridWrapped(grid, bottom - n) = 0;
+
+  PostAppClearRows(appState, bottom - n + 1, n);
+  PostAppDamageScroll(grid, top, bottom, -(pint32) n);
+
+  if (!top && bottom == grid->height - 1) {
+    if (grid->head < n)
+      grid->head += grid->height;
+    grid->head -= n;
+  } else {
+    PostAppReverseRows(grid, top, bottom - n);
+    PostAppReverseRows(grid, bottom - n + 1, bottom);
+    PostAppReverseRows(grid, top, bottom);
+  }
+}
+
+void
+PostAppInit(PostAppState* appState)
+{
+  memset(appState, 0, sizeof(PostAppState));
+
+  PostLoadConfig(&appState->config);
+  PostParserInit(&appState->parser);
+  PostLoggerInit(&appState->logger);
+  PostClusterTableInit(&appState->clusters);
+  PostScrollbackInit(&appState->scrollback,
+                     appState->config.scrollbackSize,
+                     appState->config.scrollbackSpill);
+
+  PostPaletteInit(
+    &appState->palette, appState->config.fg, appState->config.bg);
+
+  // NOTE: the default style is all default colours, which the palette
+  // resolves to config.fg and config.bg
+  appState->cursor.attrs = (PostStyle) { 0 };
+
+  PostStyleTableInit(&appState->styles, &appState->cursor.attrs);
+}
+
+void
+PostAppFini(PostAppState* appState)
+{
+  PostAppStopLogging(appState);
+  PostParserFini(&appState->parser);
+  PostStringRelease(&appState->title);
+  PostScrollbackFini(&appState->scrollback);
+  PostClusterTableFini(&appState->clusters);
+  PostStyleTableFini(&appState->styles);
+  PostAppFreeGrid(appState, &appState->grid, 0);
+  PostAppFreeGrid(appState, &appState->otherGrid, 0);
+}
+
+pusize
+PostAppWriteBytes(PostAppState* appState, const puint8* data, pusize len)
+{
+  return PostParse(appState, data, len);
+}
+
+PostError
+PostAppSetTitle(PostAppState* appState, const char* title, pusize len)
+{
+  appState->title.size = 0;
+  appState->titleDirty = 1;
+
+  PostTry(PostStringAppend(&appState->title, title, len));
+
+  return PostStringAppendChar(&appState->title, 0);
+}
+
+PostError
+PostAppFlushTitle(PostAppState* appState)
 {
-  PostParser* parser = &appState->parser;
-  PostCursor  cursor = appState->cursor;
-  char        ch;
+  if (!appState->titleDirty || !appState->title.size)
+    return POST_ERR_NONE;
+
+  appState->titleDirty = 0;
+
+  if (appState->renderer == NULL || appState->renderer->SetWindowTitle == NULL)
+    return POST_ERR_UNSUPPORTED;
+
+  return appState->renderer->SetWindowTitle(appState, appState->title.buf);
+}
 
-ParserLoop:
-  ch = str[0];
+/**
+ * the cells of row y that are reflowed, trailing empty cells of a row that
+ * does not wrap are left out since nothing was ever written there
+ */
+static puint32
+PostAppRowLength(const PostCellGrid* grid, puint32 y)
+{
+  const PostCell* row = PostGridRow(grid, y);
+  puint32         len = *PostGridBlankFrom(grid, y);
 
-  if (!ch)
-    goto AssignCursor;
+  if (!*PostGridWrapped(grid, y))
+    while (len &&
+           !(row[len - 1].charCode | row[len - 1].style | row[len - 1].flags))
+      --len;
 
-  switch (appState->parser.state) {
-    case POST_PARSER_STATE_NORMAL:
+  return len;
+}
+
+/**
+ * moves the text of the screen into text as lines, a line ends at lineEnds
+ * and takes up as many rows as it wrapped over, the cursor ends up as an
+ * offset into text, returns the number of lines
+ */
+static puint32
+PostAppUnwrapScreen(PostAppState*     appState,
+                    const PostCursor* cursor,
+                    PostCell*         text,
+                    puint32           numCells,
+                    puint32*          lineEnds,
+                    puint32*          cursorLine,
+                    puint32*          cursorOffset)
+{
+  PostCellGrid* grid     = &appState->grid;
+  puint32       numLines = 0, last = cursor->y;
+
+  // NOTE: blank rows below the cursor are not text, they are dropped
+  for (puint32 y = grid->height; y-- > cursor->y + 1;)
+    if (*PostGridBlankFrom(grid, y)) {
+      last = y;
       break;
-    case POST_PARSER_STATE_ESC:
-      switch (ch) {
-        case POST_UNICODE_LBRACK:
-          parser->state         = POST_PARSER_STATE_CSI;
-          parser->isPrivate     = 0;
-          parser->attribs       = NULL;
-          parser->currentAttrib = NULL;
-          ++str;
-          break;
-        case POST_UNICODE_RBRACK:
-          parser->state     = POST_PARSER_STATE_OSC;
-          parser->parseText = 0;
-          parser->s         = 255;
-          parser->t         = (PostString) { 0 };
-          ++str;
-          break;
-        case POST_UNICODE_LPAREN:
-          parser->state = POST_PARSER_STATE_DESIGNATE_G0;
-          ++str;
-          break;
-        case POST_UNICODE_E: // NEL
-          cursor.lastColumnFlag = 0;
-          cursor.x              = 0;
-          cursor.y              = PostAppAdvanceY(appState->grid, cursor.y);
-          break;
-        default:
-          parser->state = POST_PARSER_STATE_NORMAL;
-          ++str;
-          // FIXME: create warn logging function
-          PostAppLogWarning(appState, "Unknown Escape Sequence: ESC '%c'", ch);
-          break;
-      }
+    }
+
+  *cursorLine   = 0;
+  *cursorOffset = numCells;
+
+  for (puint32 y = 0; y <= last && y < grid->height; ++y) {
+    PostCell* row   = PostGridRow(grid, y);
+    puint32   len   = PostAppRowLength(grid, y);
+    pbool     wraps = *PostGridWrapped(grid, y) && y < last;
 
-      goto ParserLoop;
-    case POST_PARSER_STATE_DESIGNATE_G0:
-      parser->state = POST_PARSER_STATE_NORMAL;
-      ++str;
-      goto ParserLoop;
-    case POST_PARSER_STATE_CSI:
-      PostParseCSI(appState, &cursor, ch);
-      ++str;
-      goto ParserLoop;
-    case POST_PARSER_STATE_OSC:
-      if (parser->parseText) {
-        PostError error;
-
-        if (ch == POST_UNICODE_BEL) {
-          error = PostStringAppendChar(&parser->t, 0);
-          if (error != POST_ERR_NONE)
-            PostAppLogWarning(
-              appState, "OSC Failed: '%s'", PostErrorString(error));
-          else
-            PostAppSetTitle(appState, parser->t.buf);
-          PostStringRelease(&parser->t);
-          parser->state = POST_PARSER_STATE_NORMAL;
-        } else {
-          error = PostStringAppendChar(&parser->t, ch);
-          if (error != POST_ERR_NONE)
-            PostAppLogWarning(
-              appState, "OSC Failed: '%s'", PostErrorString(error));
-        }
-      } else {
-        if (parser->s != 255) {
-          if (ch != POST_UNICODE_SEMICOLON) {
-            parser->state = POST_PARSER_STATE_NORMAL;
-            PostAppLogWarning(
-              appState, "Invalid OSC: Expected ';' But Got '%c'", ch);
-            goto ParserLoop;
+    // NOTE: a wide character that did not fit at the end of the row left a
+    // blank cell behind
+    if (wraps && len == grid->width &&
+        !(row[len - 1].charCode | row[len - 1].flags) &&
+        *PostGridBlankFrom(grid, y + 1) &&
+        PostGridRow(grid, y + 1)[0].flags & POST_CELL_WIDE)
+      PostAppReleaseCells(appState, row + --len, 1);
+
+    if (y == cursor->y) {
+      *cursorLine   = numLines;
+      *cursorOffset = numCells + cursor->x + cursor->lastColumnFlag;
+    }
+
+    memcpy(text + numCells, row, len * sizeof(PostCell));
+    numCells += len;
+
+    if (!wraps)
+      lineEnds[numLines++] = numCells;
+  }
+
+  if (!numLines)
+    lineEnds[numLines++] = numCells;
+
+  return numLines;
+}
+
+/**
+ * reflows the primary screen in grid to width x height around cursor, see
+ * PostAppSizeGrid
+ */
+static PostError
+PostAppReflowGrid(PostAppState* appState,
+                  PostCursor*   cursor,
+                  puint32       width,
+                  puint32       height)
+{
+  PostCellGrid*   grid = &appState->grid;
+  PostCell*       cells;
+  PostCell*       text;
+  puint32*        rows;
+  puint32*        blankFrom;
+  puint32*        lineEnds;
+  pbool*          wrapped;
+  PostRowDamage*  damage;
+  const PostCell* popped;
+  puint32         popLen, numLines, cursorLine, cursorOffset;
+  puint32         numRows = 0, skip = 0;
+
+  if (grid->cells != NULL && width == grid->width && height == grid->height)
+    return POST_ERR_NONE;
+
+  cells     = malloc((pusize) width * height * sizeof(PostCell));
+  rows      = malloc(height * sizeof(*rows));
+  blankFrom = malloc(height * sizeof(*blankFrom));
+  wrapped   = calloc(height, sizeof(*wrapped));
+  damage    = calloc(height, sizeof(*damage));
+  lineEnds  = malloc((grid->height + 1) * sizeof(*lineEnds));
+
+  // NOTE: the line the top row went on from is reflowed along with the
+  // screen, the rest of the scrollback keeps its lines whole
+  popped = PostScrollbackPopWrapped(appState, &popLen);
+  text   = malloc(((pusize) grid->width * grid->height + popLen + 1) *
+                sizeof(PostCell));
+
+  if (cells == NULL || rows == NULL || blankFrom == NULL || wrapped == NULL ||
+      damage == NULL || lineEnds == NULL || text == NULL) {
+    if (popped != NULL)
+      PostScrollbackPush(appState, popped, popLen, 1);
+
+    free(cells);
+    free(rows);
+    free(blankFrom);
+    free(wrapped);
+    free(damage);
+    free(lineEnds);
+    free(text);
+
+    return POST_ERR_OUT_OF_MEMORY;
+  }
+
+  if (popped != NULL)
+    memcpy(text, popped, popLen * sizeof(PostCell));
+
+  numLines = PostAppUnwrapScreen(
+    appState, cursor, text, popLen, lineEnds, &cursorLine, &cursorOffset);
+
+  // NOTE: the first pass only counts rows and finds the cursor, the second
+  // moves the cells, the rows that do not fit above the cursor go to the
+  // scrollback and the ones that do not fit below it are dropped
+  for (int pass = 0; pass < 2; ++pass) {
+    puint32 row = 0;
+
+    for (puint32 l = 0, start = 0; l < numLines; ++l) {
+      puint32 end = lineEnds[l];
+
+      do {
+        puint32 rowEnd = PostCellWrap(text, start, end, width);
+        puint32 len    = rowEnd - start;
+        pbool   wraps  = rowEnd < end;
+
+        if (!pass) {
+          if (l == cursorLine && (cursorOffset < rowEnd || !wraps) &&
+              start <= cursorOffset) {
+            numRows                = row;
+            cursor->x              = cursorOffset - start;
+            cursor->lastColumnFlag = cursor->x == width && !wraps;
+
+            if (cursor->x >= width)
+              cursor->x = width - 1;
+          }
+        } else if (row < skip)
+          PostScrollbackPush(appState, text + start, len, wraps);
+        else if (row - skip < height) {
+          puint32 y = row - skip;
+
+          // NOTE: only a wide character on a grid one column wide overflows
+          if (len > width) {
+            PostAppReleaseCells(appState, text + start + width, len - width);
+            text[start].flags &= ~POST_CELL_WIDE;
+            len = width;
           }
-          parser->parseText = 1;
-          ++str;
-          goto ParserLoop;
-        }
-
-        switch (ch) {
-          case POST_UNICODE_0:
-          case POST_UNICODE_1:
-          case POST_UNICODE_2:
-            parser->s = ch - POST_UNICODE_0;
-            break;
-          default:
-            parser->state = POST_PARSER_STATE_NORMAL;
-            PostAppLogWarning(appState, "Invalid OSC Command: '%c'", ch);
-            break;
-        }
-      }
 
-      ++str;
-      goto ParserLoop;
-  }
-
-  for (; str[0]; ++str) {
-    switch (str[0]) {
-      case POST_UNICODE_BEL:
-        continue;
-      case POST_UNICODE_BS:
-        cursor.lastColumnFlag = 0;
-        if (cursor.x)
-          --cursor.x;
-        else if (cursor.y) {
-          cursor.x = appState->grid.width - 1;
-          --cursor.y;
-        }
-        continue;
-      case POST_UNICODE_HT:
-        cursor.lastColumnFlag = 0;
-        for (int i = 0; i < appState->config.tabWidth; ++i)
-          PostAppAdvance(appState->grid, &cursor);
-        continue;
-      case POST_UNICODE_LF:
-      case POST_UNICODE_FF:
-        cursor.lastColumnFlag = 0;
-        cursor.x              = 0;
-        cursor.y              = PostAppAdvanceY(appState->grid, cursor.y);
-        continue;
-      case POST_UNICODE_CR:
-        cursor.lastColumnFlag = 0;
-        cursor.x              = 0;
-        continue;
-      case POST_UNICODE_ESC:
-        parser->state = POST_PARSER_STATE_ESC;
-        ++str;
-        goto ParserLoop;
-      case POST_UNICODE_SUB:
-        goto ParserLoop;
-      default:
-        break;
+          memcpy(
+            cells + (pusize) y * width, text + start, len * sizeof(*text));
+          blankFrom[y] = len;
+          wrapped[y]   = wraps;
+        } else
+          PostAppReleaseCells(appState, text + start, len);
+
+        start = rowEnd;
+        ++row;
+      } while (start < end);
     }
 
-    if (cursor.lastColumnFlag) {
-      cursor.lastColumnFlag = 0;
-      cursor.x              = 0;
-      cursor.y              = PostAppAdvanceY(appState->grid, cursor.y);
+    // NOTE: numRows holds the cursor's row after the first pass
+    if (!pass) {
+      if (row > height)
+        skip = row - height < numRows ? row - height : numRows;
+
+      cursor->y = numRows - skip;
+      numRows   = row - skip < height ? row - skip : height;
     }
+  }
 
-    appState->grid.cells[cursor.y * appState->grid.width + cursor.x] =
-      (PostCell) {
-        .charCode = (unsigned char) str[0],
-        .fg       = cursor.fg,
-        .bg       = cursor.bg,
-        .sgr      = cursor.sgr,
-      };
+  for (puint32 y = 0; y < height; ++y) {
+    rows[y] = y;
 
-    PostAppAdvance(appState->grid, &cursor);
+    if (y >= numRows)
+      blankFrom[y] = 0;
   }
 
-AssignCursor:
-  appState->cursor = cursor;
+  free(grid->cells);
+  free(grid->rows);
+  free(grid->blankFrom);
+  free(grid->wrapped);
+  free(grid->damage);
+  free(lineEnds);
+  free(text);
+
+  grid->byteSize  = (pusize) width * height * sizeof(PostCell);
+  grid->cells     = cells;
+  grid->rows      = rows;
+  grid->blankFrom = blankFrom;
+  grid->wrapped   = wrapped;
+  grid->damage    = damage;
+  grid->head      = 0;
+  grid->width     = width;
+  grid->height    = height;
+
+  return POST_ERR_NONE;
+}
+
+/**
+ * cuts the alternate screen in grid to width x height, programs on the
+ * alternate screen redraw it when the size changes so it is not reflowed
+ */
+static PostError
+PostAppCropGrid(PostAppState* appState, puint32 width, puint32 height)
+{
+  PostCellGrid* grid = &appState->grid;
+  PostCellGrid  cropped;
+
+  PostTry(PostAppAllocGrid(&cropped, width, height));
+
+  for (puint32 y = 0; y < grid->height; ++y) {
+    PostCell* row = PostGridRow(grid, y);
+    puint32   len = *PostGridBlankFrom(grid, y);
+    puint32   n   = len < width ? len : width;
+
+    if (y >= height)
+      n = 0;
+    else if (n == width && row[n - 1].flags & POST_CELL_WIDE)
+      --n;
+
+    PostAppReleaseCells(appState, row + n, len - n);
+
+    if (n) {
+      memcpy(cropped.cells + (pusize) y * width, row, n * sizeof(PostCell));
+      cropped.blankFrom[y] = n;
+    }
+  }
+
+  PostAppFreeGrid(appState, grid, 0);
+  *grid = cropped;
+
+  return POST_ERR_NONE;
+}
+
+static void
+PostAppSwapGrids(PostAppState* appState)
+{
+  PostCellGrid grid = appState->grid;
+
+  appState->grid      = appState->otherGrid;
+  appState->otherGrid = grid;
 }
 
 PostError
 PostAppSizeGrid(PostAppState* appState)
 {
   PostRenderer* renderer = appState->renderer;
-  pusize        byteSize;
-  puint32       gridWidth  = renderer->windowWidth / renderer->cellWidth;
-  puint32       gridHeight = renderer->windowHeight / renderer->cellHeight;
+  PostCursor*   cursor   = &appState->cursor;
+  PostCursor*   saved    = &appState->savedCursor;
+  puint32       width    = renderer->windowWidth / renderer->cellWidth;
+  puint32       height   = renderer->windowHeight / renderer->cellHeight;
+  PostError     error;
+
+  if (!width)
+    width = 1;
+
+  if (!height)
+    height = 1;
 
-  if (!gridWidth)
-    gridWidth = 1;
+  if (appState->grid.cells != NULL && width == appState->grid.width &&
+      height == appState->grid.height)
+    return POST_ERR_NONE;
 
-  if (!gridHeight)
-    gridHeight = 1;
+  if (!appState->altScreen) {
+    PostTry(PostAppReflowGrid(appState, cursor, width, height));
 
-  byteSize = gridWidth * gridHeight * sizeof(PostCell);
+    // NOTE: the alternate screen is allocated again on the next switch
+    PostAppFreeGrid(appState, &appState->otherGrid, 1);
+  } else {
+    // NOTE: the primary screen is reflowed around the cursor saved on the
+    // way to the alternate screen, which is where it comes back to
+    PostAppSwapGrids(appState);
+    appState->altScreen = 0;
 
-  if (byteSize > appState->grid.byteSize) {
-    PostCell* cells = realloc(appState->grid.cells, byteSize);
-    if (cells == NULL)
-      return POST_ERR_OUT_OF_MEMORY;
-    memset(cells, 0, byteSize);
-    appState->grid.byteSize = byteSize;
-    appState->grid.cells    = cells;
+    // NOTE: the cursor may have been saved on a screen of another size
+    if (saved->x >= appState->grid.width || saved->y >= appState->grid.height)
+      *saved = (PostCursor) { .style = saved->style, .attrs = saved->attrs };
+
+    error = PostAppReflowGrid(appState, saved, width, height);
+
+    PostAppSwapGrids(appState);
+    appState->altScreen = 1;
+
+    if (error != POST_ERR_NONE)
+      return error;
+
+    PostTry(PostAppCropGrid(appState, width, height));
+
+    if (cursor->x >= width || cursor->y >= height)
+      cursor->lastColumnFlag = 0;
+    if (cursor->x >= width)
+      cursor->x = width - 1;
+    if (cursor->y >= height)
+      cursor->y = height - 1;
+  }
+
+  appState->scrollTop    = 0;
+  appState->scrollBottom = height - 1;
+
+  PostGridDamageRows(&appState->grid, 0, height - 1);
+
+  return POST_ERR_NONE;
+}
+
+void
+PostAppSaveCursor(PostAppState* appState, PostCursor* cursor)
+{
+  PostCursor* saved = &appState->savedCursor;
+
+  PostStyleRetain(&appState->styles, cursor->style, 1);
+  PostStyleRelease(&appState->styles, saved->style, 1);
+
+  saved->x              = cursor->x;
+  saved->y              = cursor->y;
+  saved->lastColumnFlag = cursor->lastColumnFlag;
+  saved->attrs          = cursor->attrs;
+  saved->style          = cursor->style;
+}
+
+void
+PostAppRestoreCursor(PostAppState* appState, PostCursor* cursor)
+{
+  PostCursor* saved = &appState->savedCursor;
+
+  PostStyleRetain(&appState->styles, saved->style, 1);
+  PostStyleRelease(&appState->styles, cursor->style, 1);
+
+  cursor->lastColumnFlag = saved->lastColumnFlag;
+  cursor->x              = saved->x;
+  cursor->y              = saved->y;
+  cursor->attrs          = saved->attrs;
+  cursor->style          = saved->style;
+
+  if (cursor->x >= appState->grid.width) {
+    cursor->x              = appState->grid.width - 1;
+    cursor->lastColumnFlag = 0;
+  }
+
+  if (cursor->y >= appState->grid.height)
+    cursor->y = appState->grid.height - 1;
+}
+
+PostError
+PostAppSetAltScreen(PostAppState* appState,
+                    PostCursor*   cursor,
+                    pbool         alt,
+                    pbool         clear)
+{
+  PostCellGrid* other = &appState->otherGrid;
+
+  if (alt == appState->altScreen)
+    return POST_ERR_NONE;
+
+  if (alt && (other->width != appState->grid.width ||
+              other->height != appState->grid.height)) {
+    PostAppFreeGrid(appState, other, 1);
+    PostTry(
+      PostAppAllocGrid(other, appState->grid.width, appState->grid.height));
   }
 
-  appState->grid.width  = gridWidth;
-  appState->grid.height = gridHeight;
+  // NOTE: rows of the alternate screen are cleared while it is up so none of
+  // them goes to the scrollback
+  if (clear && !alt)
+    PostAppClearRows(appState, 0, appState->grid.height);
+
+  PostAppSwapGrids(appState);
+  appState->altScreen = alt;
+
+  if (clear && alt)
+    PostAppClearRows(appState, 0, appState->grid.height);
+
+  PostGridDamageRows(&appState->grid, 0, appState->grid.height - 1);
+
+  cursor->lastColumnFlag = 0;
 
   return POST_ERR_NONE;
 }
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+// NOTE: the shuffle codec is built for SSSE3 whatever the baseline and only
+// used when the CPU it runs on has it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define POST_BASE64_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+#include "post/base64.h"
+#include "post/compiler.h"
+
+#define POST_BASE64_INVALID 0xFF
+
+static const char base64Alphabet[64] =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// NOTE: values are stored plus one so the zeroed entries mark invalid input
+static const puint8 base64Values[256] = {
+  ['A'] = 1, ['B'] = 2, ['C'] = 3, ['D'] = 4, ['E'] = 5, ['F'] = 6, ['G'] = 7,
+  ['H'] = 8, ['I'] = 9, ['J'] = 10, ['K'] = 11, ['L'] = 12, ['M'] = 13,
+  ['N'] = 14, ['O'] = 15, ['P'] = 16, ['Q'] = 17, ['R'] = 18, ['S'] = 19,
+  ['T'] = 20, ['U'] = 21, ['V'] = 22, ['W'] = 23, ['X'] = 24, ['Y'] = 25,
+  ['Z'] = 26, ['a'] = 27, ['b'] = 28, ['c'] = 29, ['d'] = 30, ['e'] = 31,
+  ['f'] = 32, ['g'] = 33, ['h'] = 34, ['i'] = 35, ['j'] = 36, ['k'] = 37,
+  ['l'] = 38, ['m'] = 39, ['n'] = 40, ['o'] = 41, ['p'] = 42, ['q'] = 43,
+  ['r'] = 44, ['s'] = 45, ['t'] = 46, ['u'] = 47, ['v'] = 48, ['w'] = 49,
+  ['x'] = 50, ['y'] = 51, ['z'] = 52, ['0'] = 53, ['1'] = 54, ['2'] = 55,
+  ['3'] = 56, ['4'] = 57, ['5'] = 58, ['6'] = 59, ['7'] = 60, ['8'] = 61,
+  ['9'] = 62, ['+'] = 63, ['/'] = 64,
+};
+
+static inline puint8
+PostBase64Value(puint8 ch)
+{
+  return base64Values[ch] ? base64Values[ch] - 1 : POST_BASE64_INVALID;
+}
+
+#if defined(POST_BASE64_SSSE3)
+
+/*
+ * Muła and Lemire, "Faster Base64 Encoding and Decoding Using AVX2
+ * Instructions": characters are classified by their nibbles with two
+ * shuffles, translated with a third and packed from 16 sextets into 12
+ * bytes with multiply-adds.
+ */
+
+static const _Alignas(16) puint8 decodeLowTable[16] = {
+  0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+  0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+};
+
+static const _Alignas(16) puint8 decodeHighTable[16] = {
+  0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+};
+
+// NOTE: offsets are added modulo 256, 0xBF is -65 and 0xB9 is -71
+static const _Alignas(16) puint8 decodeRollTable[16] = {
+  0x00, 0x10, 0x13, 0x04, 0xBF, 0xBF, 0xB9, 0xB9,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static const _Alignas(16) puint8 decodePackTable[16] = {
+  2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 0x80, 0x80, 0x80, 0x80,
+};
+
+static const _Alignas(16) puint8 encodeSplitTable[16] = {
+  1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+};
+
+// NOTE: 'a' - 26, '0' - 52 (x10), '+' - 62, '/' - 63, 'A', modulo 256
+static const _Alignas(16) puint8 encodeShiftTable[16] = {
+  0x47, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC,
+  0xFC, 0xFC, 0xFC, 0xED, 0xF0, 0x41, 0x00, 0x00,
+};
+
+/**
+ * decodes whole 16 character blocks into 12 bytes each, stops at the first
+ * block holding anything but the 64 alphabet characters, returns the number
+ * of blocks decoded. Every store writes 16 bytes.
+ */
+TARGET("ssse3") static pusize
+PostBase64DecodeBlocks(const puint8* in, pusize len, puint8* out)
+{
+  const __m128i lowTable  = _mm_load_si128((const __m128i*) decodeLowTable);
+  const __m128i highTable = _mm_load_si128((const __m128i*) decodeHighTable);
+  const __m128i rollTable = _mm_load_si128((const __m128i*) decodeRollTable);
+  const __m128i packTable = _mm_load_si128((const __m128i*) decodePackTable);
+  const __m128i nibble    = _mm_set1_epi8(0x0F);
+  const __m128i slash     = _mm_set1_epi8(0x2F);
+  pusize        blocks    = 0;
+
+  for (; len >= 16; len -= 16, in += 16, out += 12, ++blocks) {
+    __m128i v      = _mm_loadu_si128((const __m128i*) in);
+    __m128i high   = _mm_and_si128(_mm_srli_epi32(v, 4), nibble);
+    __m128i low    = _mm_shuffle_epi8(lowTable, _mm_and_si128(v, nibble));
+    __m128i bad    = _mm_and_si128(low, _mm_shuffle_epi8(highTable, high));
+    __m128i roll   = _mm_shuffle_epi8(
+      rollTable, _mm_add_epi8(_mm_cmpeq_epi8(v, slash), high));
+    __m128i merged;
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(bad, _mm_setzero_si128())) != 0xFFFF)
+      break;
+
+    v      = _mm_add_epi8(v, roll);
+    merged = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+    merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+
+    _mm_storeu_si128((__m128i*) out, _mm_shuffle_epi8(merged, packTable));
+  }
+
+  return blocks;
+}
+
+/**
+ * encodes 12 byte groups into 16 characters while 16 bytes can be loaded,
+ * returns the number of groups encoded
+ */
+TARGET("ssse3") static pusize
+PostBase64EncodeBlocks(const puint8* in, pusize len, char* out)
+{
+  const __m128i splitTable = _mm_load_si128((const __m128i*) encodeSplitTable);
+  const __m128i shiftTable = _mm_load_si128((const __m128i*) encodeShiftTable);
+  pusize        groups     = 0;
+
+  for (; len >= 16; len -= 12, in += 12, out += 16, ++groups) {
+    __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) in),
+                                 splitTable);
+    __m128i a = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0FC0FC00)),
+                                _mm_set1_epi32(0x04000040));
+    __m128i b = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003F03F0)),
+                                _mm_set1_epi32(0x01000010));
+    __m128i indices = _mm_or_si128(a, b);
+    __m128i shift   = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+
+    shift = _mm_or_si128(
+      shift,
+      _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices),
+                    _mm_set1_epi8(13)));
+
+    _mm_storeu_si128(
+      (__m128i*) out,
+      _mm_add_epi8(_mm_shuffle_epi8(shiftTable, shift), indices));
+  }
+
+  return groups;
+}
+
+#endif
+
+pbool
+PostBase64IsVectorized(void)
+{
+#if defined(POST_BASE64_SSSE3)
+  return __builtin_cpu_supports("ssse3");
+#else
+  return 0;
+#endif
+}
+
+pusize
+PostBase64Decode(PostBase64Decoder* decoder,
+                 const puint8*      in,
+                 pusize             len,
+                 puint8*            out)
+{
+  puint8* start = out;
+  pusize  i     = 0;
+
+#if defined(POST_BASE64_SSSE3)
+  pbool ssse3 = PostBase64IsVectorized();
+#endif
+
+  if (decoder->invalid)
+    return 0;
+
+  while (i < len) {
+    puint8 ch = in[i], value;
+
+#if defined(POST_BASE64_SSSE3)
+    if (ssse3 && !decoder->numChars && !decoder->padded) {
+      pusize blocks = PostBase64DecodeBlocks(in + i, len - i, out);
+
+      i += blocks * 16;
+      out += blocks * 12;
+
+      if (i == len)
+        break;
+
+      ch = in[i];
+    }
+#endif
+
+    ++i;
+
+    if (decoder->padded) {
+      if (ch != '=') {
+        decoder->invalid = 1;
+        break;
+      }
+      continue;
+    }
+
+    if (ch == '=') {
+      // NOTE: padding flushes the partial quantum, 'xx=' and 'xxx=' only
+      if (decoder->numChars < 2) {
+        decoder->invalid = 1;
+        break;
+      }
+      out += PostBase64DecodeFinish(decoder, out);
+      decoder->padded = 1;
+      continue;
+    }
+
+    if ((value = PostBase64Value(ch)) == POST_BASE64_INVALID) {
+      decoder->invalid = 1;
+      break;
+    }
+
+    decoder->bits = (decoder->bits << 6) | value;
+
+    if (++decoder->numChars == 4) {
+      out[0]            = decoder->bits >> 16;
+      out[1]            = decoder->bits >> 8;
+      out[2]            = decoder->bits;
+      out               = out + 3;
+      decoder->bits     = 0;
+      decoder->numChars = 0;
+    }
+  }
+
+  return out - start;
+}
+
+pusize
+PostBase64DecodeFinish(PostBase64Decoder* decoder, puint8* out)
+{
+  pusize n = 0;
+
+  switch (decoder->numChars) {
+    case 0:
+      break;
+    case 1:
+      decoder->invalid = 1;
+      break;
+    case 2:
+      out[n++] = decoder->bits >> 4;
+      break;
+    case 3:
+      out[n++] = decoder->bits >> 10;
+      out[n++] = decoder->bits >> 2;
+      break;
+  }
+
+  decoder->bits     = 0;
+  decoder->numChars = 0;
+
+  return n;
+}
+
+pusize
+PostBase64Encode(const puint8* in, pusize len, char* out)
+{
+  char*  start = out;
+  pusize i     = 0;
+
+#if defined(POST_BASE64_SSSE3)
+  if (PostBase64IsVectorized()) {
+    pusize groups = PostBase64EncodeBlocks(in, len, out);
+
+    i = groups * 12;
+    out += groups * 16;
+  }
+#endif
+
+  for (; i + 3 <= len; i += 3, out += 4) {
+    puint32 bits = (puint32) in[i] << 16 | (puint32) in[i + 1] << 8 | in[i + 2];
+
+    out[0] = base64Alphabet[bits >> 18];
+    out[1] = base64Alphabet[(bits >> 12) & 0x3F];
+    out[2] = base64Alphabet[(bits >> 6) & 0x3F];
+    out[3] = base64Alphabet[bits & 0x3F];
+  }
+
+  if (i < len) {
+    puint32 bits = (puint32) in[i] << 16;
+
+    if (i + 1 < len)
+      bits |= (puint32) in[i + 1] << 8;
+
+    out[0] = base64Alphabet[bits >> 18];
+    out[1] = base64Alphabet[(bits >> 12) & 0x3F];
+    out[2] = i + 1 < len ? base64Alphabet[(bits >> 6) & 0x3F] : '=';
+    out[3] = '=';
+    out += 4;
+  }
+
+  return out - start;
+}
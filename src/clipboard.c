@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "post/app.h"
+#include "post/base64.h"
+#include "post/clipboard.h"
+#include "post/unicode.h"
+
+// NOTE: xterm treats an empty list as "s 0", both map to the clipboard here
+static puint8
+PostClipboardSelection(const puint8* selection, pusize len)
+{
+  for (pusize i = 0; i < len; ++i)
+    if (selection[i] == POST_UNICODE_c || selection[i] == POST_UNICODE_p)
+      return selection[i];
+  return POST_UNICODE_c;
+}
+
+void
+PostClipboardBegin(PostClipboardTransfer* transfer,
+                   const puint8*          selection,
+                   pusize                 len)
+{
+  transfer->selection = PostClipboardSelection(selection, len);
+  transfer->query     = 0;
+  transfer->failed    = 0;
+  transfer->data.size = 0;
+
+  PostBase64DecoderReset(&transfer->base64);
+}
+
+void
+PostClipboardPut(PostAppState*          appState,
+                 PostClipboardTransfer* transfer,
+                 const puint8*          data,
+                 pusize                 len)
+{
+  PostString* str = &transfer->data;
+  PostError   error;
+
+  if (transfer->failed || !len)
+    return;
+
+  if (transfer->query) {
+    transfer->failed = 1;
+    PostAppLogWarning(appState, "Invalid OSC 52: Data After '?'");
+    return;
+  }
+
+  if (!str->size && !transfer->base64.numChars && data[0] == '?') {
+    transfer->query = 1;
+    PostClipboardPut(appState, transfer, data + 1, len - 1);
+    return;
+  }
+
+  if (str->size + len / 4 * 3 > appState->config.maxClipboardSize) {
+    transfer->failed = 1;
+    PostAppLogWarning(appState,
+                      "OSC 52 Exceeds %zu Bytes: Discarding",
+                      (size_t) appState->config.maxClipboardSize);
+    return;
+  }
+
+  error = PostStringReserve(str, str->size + PostBase64DecodedSize(len));
+
+  if (error != POST_ERR_NONE) {
+    transfer->failed = 1;
+    PostAppLogWarning(appState, "OSC 52 Failed: '%s'", PostErrorString(error));
+    return;
+  }
+
+  str->size += PostBase64Decode(
+    &transfer->base64, data, len, (puint8*) str->buf + str->size);
+
+  if (transfer->base64.invalid) {
+    transfer->failed = 1;
+    PostAppLogWarning(appState, "Invalid OSC 52: Bad Base64");
+  }
+}
+
+static void
+PostClipboardReply(PostAppState*          appState,
+                   PostClipboardTransfer* transfer,
+                   puint8                 terminator)
+{
+  PostString* str = &transfer->data;
+  PostString  reply;
+  pusize      header;
+  PostError   error;
+
+  if (!appState->config.allowClipboardRead) {
+    PostAppLogInfo(appState, "OSC 52 Query Ignored: Reading Is Disabled");
+    return;
+  }
+
+  str->size = 0;
+  error     = PostAppGetClipboard(appState, transfer->selection, str);
+
+  if (error != POST_ERR_NONE) {
+    PostAppLogWarning(appState, "OSC 52 Failed: '%s'", PostErrorString(error));
+    return;
+  }
+
+  reply  = (PostString) { 0 };
+  header = sizeof("\x1b]52;c;") - 1;
+  error  = PostStringReserve(&reply,
+                            header + PostBase64EncodedSize(str->size) + 2);
+
+  if (error != POST_ERR_NONE) {
+    PostAppLogWarning(appState, "OSC 52 Failed: '%s'", PostErrorString(error));
+    return;
+  }
+
+  memcpy(reply.buf, "\x1b]52;c;", header);
+  reply.buf[header - 2] = transfer->selection;
+  reply.size            = header + PostBase64Encode((const puint8*) str->buf,
+                                         str->size,
+                                         reply.buf + header);
+
+  if (terminator == POST_UNICODE_BEL)
+    reply.buf[reply.size++] = POST_UNICODE_BEL;
+  else {
+    reply.buf[reply.size++] = POST_UNICODE_ESC;
+    reply.buf[reply.size++] = POST_UNICODE_BACKSLASH;
+  }
+
+  error = PostAppReply(appState, reply.buf, reply.size);
+
+  if (error != POST_ERR_NONE)
+    PostAppLogWarning(appState, "OSC 52 Failed: '%s'", PostErrorString(error));
+
+  PostStringRelease(&reply);
+}
+
+void
+PostClipboardEnd(PostAppState*          appState,
+                 PostClipboardTransfer* transfer,
+                 puint8                 terminator)
+{
+  PostString* str = &transfer->data;
+  PostError   error;
+
+  if (transfer->failed)
+    return;
+
+  if (transfer->query) {
+    PostClipboardReply(appState, transfer, terminator);
+    return;
+  }
+
+  error = PostStringReserve(str, str->size + 3);
+
+  if (error == POST_ERR_NONE) {
+    str->size += PostBase64DecodeFinish(&transfer->base64,
+                                        (puint8*) str->buf + str->size);
+
+    if (transfer->base64.invalid) {
+      PostAppLogWarning(appState, "Invalid OSC 52: Bad Base64");
+      return;
+    }
+
+    error = PostStringAppendChar(str, 0);
+  }
+
+  if (error == POST_ERR_NONE)
+    error = PostAppSetClipboard(appState, transfer->selection, str->buf);
+
+  if (error != POST_ERR_NONE)
+    PostAppLogWarning(appState, "OSC 52 Failed: '%s'", PostErrorString(error));
+}
+
+void
+PostClipboardRelease(PostClipboardTransfer* transfer)
+{
+  PostStringRelease(&transfer->data);
+}
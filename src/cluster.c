@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "post/cluster.h"
+
+#define POST_CLUSTER_MIN_TRIM 4096
+
+void
+PostClusterTableInit(PostClusterTable* table)
+{
+  *table = (PostClusterTable) { .freeCluster = POST_CLUSTER_NONE };
+}
+
+void
+PostClusterTableFini(PostClusterTable* table)
+{
+  free(table->clusters);
+  free(table->pool);
+  PostClusterTableInit(table);
+}
+
+void
+PostClusterTableClear(PostClusterTable* table)
+{
+  table->numClusters = 0;
+  table->freeCluster = POST_CLUSTER_NONE;
+  table->numLive     = 0;
+  table->poolSize    = 0;
+  table->poolLive    = 0;
+}
+
+static PostError
+PostClusterReservePool(PostClusterTable* table, puint32 len)
+{
+  puint32  maxPool = table->maxPool;
+  puint32* pool;
+
+  if (table->poolSize + len <= maxPool)
+    return POST_ERR_NONE;
+
+  if (!maxPool)
+    maxPool = 64;
+
+  while (table->poolSize + len > maxPool)
+    maxPool <<= 1;
+
+  pool = realloc(table->pool, maxPool * sizeof(*pool));
+  if (pool == NULL)
+    return POST_ERR_OUT_OF_MEMORY;
+
+  table->pool    = pool;
+  table->maxPool = maxPool;
+
+  return POST_ERR_NONE;
+}
+
+static PostError
+PostClusterAllocate(PostClusterTable* table, puint32* index)
+{
+  if (table->freeCluster != POST_CLUSTER_NONE) {
+    *index             = table->freeCluster;
+    table->freeCluster = table->clusters[*index].offset;
+    return POST_ERR_NONE;
+  }
+
+  if (table->numClusters == table->maxClusters) {
+    puint32      maxClusters = table->maxClusters ? table->maxClusters << 1 : 64;
+    PostCluster* clusters;
+
+    if (maxClusters > POST_CLUSTER_TAG)
+      return POST_ERR_OUT_OF_MEMORY;
+
+    clusters = realloc(table->clusters, maxClusters * sizeof(*clusters));
+    if (clusters == NULL)
+      return POST_ERR_OUT_OF_MEMORY;
+
+    table->clusters    = clusters;
+    table->maxClusters = maxClusters;
+  }
+
+  *index = table->numClusters++;
+
+  return POST_ERR_NONE;
+}
+
+void
+PostClusterFree(PostClusterTable* table, puint32 index)
+{
+  PostCluster* cluster = table->clusters + index;
+
+  table->poolLive -= cluster->len;
+  cluster->offset    = table->freeCluster;
+  cluster->len       = 0;
+  table->freeCluster = index;
+
+  // NOTE: nothing references the pool anymore so it is reset for free
+  if (!--table->numLive) {
+    table->numClusters = 0;
+    table->freeCluster = POST_CLUSTER_NONE;
+    table->poolSize    = 0;
+  }
+}
+
+PostError
+PostClusterExtend(PostClusterTable* table,
+                  puint32*          charCode,
+                  puint32           codepoint)
+{
+  PostCluster* cluster;
+  puint32      index, len = 1, offset = 0;
+  pbool        shared = 1;
+
+  if (PostIsCluster(*charCode)) {
+    index   = *charCode & ~POST_CLUSTER_TAG;
+    cluster = table->clusters + index;
+    len     = cluster->len;
+    offset  = cluster->offset;
+    shared  = cluster->refs > 1;
+
+    if (len == POST_CLUSTER_MAX_CODEPOINTS)
+      return POST_ERR_NONE;
+
+    // NOTE: the only reference to a cluster at the end of the pool grows it
+    // in place
+    if (!shared && offset + len == table->poolSize) {
+      PostTry(PostClusterReservePool(table, 1));
+      table->pool[table->poolSize++] = codepoint;
+      ++cluster->len;
+      ++table->poolLive;
+      return POST_ERR_NONE;
+    }
+  }
+
+  PostTry(PostClusterReservePool(table, len + 1));
+
+  if (PostIsCluster(*charCode))
+    memcpy(table->pool + table->poolSize,
+           table->pool + offset,
+           len * sizeof(*table->pool));
+  else
+    table->pool[table->poolSize] = *charCode;
+
+  table->pool[table->poolSize + len] = codepoint;
+
+  if (shared) {
+    puint32 old = *charCode;
+
+    PostTry(PostClusterAllocate(table, &index));
+    PostClusterRelease(table, old);
+
+    ++table->numLive;
+    table->clusters[index].refs = 1;
+  } else
+    table->poolLive -= len;
+
+  cluster         = table->clusters + index;
+  cluster->offset = table->poolSize;
+  cluster->len    = len + 1;
+  table->poolSize += len + 1;
+  table->poolLive += len + 1;
+
+  *charCode = POST_CLUSTER_TAG | index;
+
+  return POST_ERR_NONE;
+}
+
+void
+PostClusterTableTrim(PostClusterTable* table)
+{
+  puint32* pool;
+  puint32  size = 0, maxPool = table->maxPool;
+
+  if (table->poolSize < POST_CLUSTER_MIN_TRIM ||
+      table->poolLive > table->poolSize / 2)
+    return;
+
+  while (maxPool > POST_CLUSTER_MIN_TRIM && maxPool / 4 >= table->poolLive)
+    maxPool >>= 1;
+
+  pool = malloc(maxPool * sizeof(*pool));
+  if (pool == NULL)
+    return;
+
+  for (puint32 i = 0; i < table->numClusters; ++i) {
+    PostCluster* cluster = table->clusters + i;
+
+    if (!cluster->refs)
+      continue;
+
+    memcpy(pool + size,
+           table->pool + cluster->offset,
+           cluster->len * sizeof(*pool));
+    cluster->offset = size;
+    size += cluster->len;
+  }
+
+  free(table->pool);
+  table->pool     = pool;
+  table->poolSize = size;
+  table->maxPool  = maxPool;
+}
@@ -21,6 +21,7 @@
  */
 
 #include "post/config.h"
+#include "post/log.h"
 
 void
 PostLoadConfig(PostConfig* config)
@@ -29,4 +30,11 @@ PostLoadConfig(PostConfig* config)
   config->bg                 = POST_COLOR_BLACK;
   config->tabWidth           = 8;
   config->bracketedPasteMode = 0;
+  config->logLevel           = POST_LOG_LEVEL_INFO;
+  config->maxStringSize      = 65536;
+  config->maxClipboardSize   = 16 << 20;
+  config->allowClipboardRead = 0;
+  config->scrollbackSize     = 16 << 20;
+  config->scrollbackSpill    = 0;
+  config->rowCacheSize       = 16 << 20;
 }
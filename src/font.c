@@ -188,13 +188,19 @@ PostFontGetGlyphMetrics(PostFont*         font,
   return POST_ERR_NONE;
 }
 
+pbool
+PostFontHasGlyph(PostFont* font, puint32 charCode)
+{
+  return charCode <= 0x10FFFF &&
+         FT_Get_Char_Index((FT_Face) font->data, charCode) != 0;
+}
+
 PostError
-PostFontLoadGlyph(PostFont* font,
-                  puint32   charCode,
-                  puint32   width,
-                  puint32   height,
-                  puint32   pitch,
-                  puint8*   bitmap)
+PostFontRenderGlyph(PostFont*        font,
+                    puint32          charCode,
+                    puint32          width,
+                    puint32          height,
+                    PostGlyphBitmap* glyph)
 {
   FT_Face      face = font->data;
   FT_GlyphSlot slot;
@@ -211,8 +217,6 @@ PostFontLoadGlyph(PostFont* font,
   if (FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL))
     return POST_ERR_RENDER_GLYPH;
 
-  memset(bitmap, 0, width * height);
-
   slot    = face->glyph;
   _bitmap = slot->bitmap;
 
@@ -227,15 +231,38 @@ PostFontLoadGlyph(PostFont* font,
   if (top < 0)
     top = 0;
 
-  puint32 minWidth  = MIN(width, left + _bitmap.width);
-  puint32 minHeight = MIN(height, top + _bitmap.rows);
+  *glyph = (PostGlyphBitmap) { .pitch = _bitmap.pitch };
 
-  for (puint32 y = top; y < minHeight; ++y) {
-    for (puint32 x = left; x < minWidth; ++x) {
-      bitmap[y * pitch + x] =
-        _bitmap.buffer[(y - top) * _bitmap.pitch + (x - left)];
-    }
-  }
+  if ((puint32) left >= width || (puint32) top >= height)
+    return POST_ERR_NONE;
+
+  glyph->left   = left;
+  glyph->top    = top;
+  glyph->width  = MIN(width - left, _bitmap.width);
+  glyph->height = MIN(height - top, _bitmap.rows);
+  glyph->bitmap = _bitmap.buffer;
+
+  return POST_ERR_NONE;
+}
+
+PostError
+PostFontLoadGlyph(PostFont* font,
+                  puint32   charCode,
+                  puint32   width,
+                  puint32   height,
+                  puint32   pitch,
+                  puint8*   bitmap)
+{
+  PostGlyphBitmap glyph;
+
+  PostTry(PostFontRenderGlyph(font, charCode, width, height, &glyph));
+
+  memset(bitmap, 0, width * height);
+
+  for (puint32 y = 0; y < glyph.height; ++y)
+    memcpy(bitmap + (glyph.top + y) * pitch + glyph.left,
+           glyph.bitmap + (pint32) y * glyph.pitch,
+           glyph.width);
 
   return POST_ERR_NONE;
 }
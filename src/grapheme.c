@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "post/grapheme.h"
+
+#define POST_GRAPHEME_JOINS_HANGUL(PREV, NEXT)                                 \
+  (((PREV) == POST_GRAPHEME_L &&                                               \
+    ((NEXT) == POST_GRAPHEME_L || (NEXT) == POST_GRAPHEME_V ||                 \
+     (NEXT) == POST_GRAPHEME_LV || (NEXT) == POST_GRAPHEME_LVT)) ||            \
+   (((PREV) == POST_GRAPHEME_LV || (PREV) == POST_GRAPHEME_V) &&               \
+    ((NEXT) == POST_GRAPHEME_V || (NEXT) == POST_GRAPHEME_T)) ||               \
+   (((PREV) == POST_GRAPHEME_LVT || (PREV) == POST_GRAPHEME_T) &&              \
+    (NEXT) == POST_GRAPHEME_T))
+
+pbool
+PostGraphemeBreakLookup(PostGraphemeBreaker* breaker, puint32 codepoint)
+{
+  puint8 prev = breaker->prev;
+  puint8 next = PostGraphemeClass(codepoint);
+  pbool  split;
+
+  if (prev == POST_GRAPHEME_CR && next == POST_GRAPHEME_LF)
+    split = 0;
+  else if (prev == POST_GRAPHEME_CR || prev == POST_GRAPHEME_LF ||
+           prev == POST_GRAPHEME_CONTROL)
+    split = 1;
+  else if (next == POST_GRAPHEME_CR || next == POST_GRAPHEME_LF ||
+           next == POST_GRAPHEME_CONTROL)
+    split = 1;
+  else if (POST_GRAPHEME_JOINS_HANGUL(prev, next))
+    split = 0;
+  else if (next == POST_GRAPHEME_EXTEND || next == POST_GRAPHEME_ZWJ ||
+           next == POST_GRAPHEME_SPACING_MARK)
+    split = 0;
+  else if (prev == POST_GRAPHEME_ZWJ && next == POST_GRAPHEME_PICTOGRAPHIC)
+    split = !breaker->pictographic;
+  else if (prev == POST_GRAPHEME_REGIONAL_INDICATOR &&
+           next == POST_GRAPHEME_REGIONAL_INDICATOR)
+    split = !breaker->oddRegional;
+  else
+    split = 1;
+
+  // NOTE: only Extend before the ZWJ keeps an emoji sequence open, anything
+  // after it has to be the next pictograph
+  if (next == POST_GRAPHEME_PICTOGRAPHIC)
+    breaker->pictographic = 1;
+  else if ((next != POST_GRAPHEME_EXTEND && next != POST_GRAPHEME_ZWJ) ||
+           prev == POST_GRAPHEME_ZWJ)
+    breaker->pictographic = 0;
+
+  breaker->oddRegional = next == POST_GRAPHEME_REGIONAL_INDICATOR &&
+                         !(prev == POST_GRAPHEME_REGIONAL_INDICATOR &&
+                           breaker->oddRegional);
+  breaker->prev = next;
+
+  return split;
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "post/app.h"
+#include "post/log.h"
+#include "post/thread.h"
+
+#define POST_LOG_RING_MASK (POST_LOG_RING_SIZE - 1)
+
+static void
+PostLogDeliver(PostAppState* appState, puint8 level, const char* message)
+{
+  void (*sink)(PostAppState*, const char*) =
+    level >= POST_LOG_LEVEL_WARNING ? appState->LogWarning : appState->LogInfo;
+
+  if (sink != NULL)
+    sink(appState, message);
+}
+
+static void
+PostLogPush(PostAppState* appState, puint8 level, const char* fmt, va_list args)
+{
+  PostLogger*  logger = &appState->logger;
+  PostLogSlot* slot;
+  puint32      pos;
+
+  if (!atomic_load_explicit(&logger->running, memory_order_acquire)) {
+    char message[POST_LOG_MESSAGE_SIZE];
+    vsnprintf(message, sizeof(message), fmt, args);
+    PostLogDeliver(appState, level, message);
+    return;
+  }
+
+  pos = atomic_load_explicit(&logger->head, memory_order_relaxed);
+
+  for (;;) {
+    pint32 diff;
+
+    slot = &logger->slots[pos & POST_LOG_RING_MASK];
+    diff = (pint32) (atomic_load_explicit(&slot->sequence,
+                                          memory_order_acquire) -
+                     pos);
+
+    if (!diff) {
+      if (atomic_compare_exchange_weak_explicit(&logger->head,
+                                                &pos,
+                                                pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      // NOTE: the ring is full, the drain thread reports the drop
+      atomic_fetch_add_explicit(&logger->dropped, 1, memory_order_relaxed);
+      return;
+    } else
+      pos = atomic_load_explicit(&logger->head, memory_order_relaxed);
+  }
+
+  slot->level = level;
+  vsnprintf(slot->message, sizeof(slot->message), fmt, args);
+
+  atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+
+  PostEventSignal(logger->wake);
+}
+
+static void
+PostLogPushFormat(PostAppState* appState, puint8 level, const char* fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  PostLogPush(appState, level, fmt, args);
+  va_end(args);
+}
+
+/** delivers every published message, returns 0 once the ring is empty */
+static pbool
+PostLogDrain(PostAppState* appState)
+{
+  PostLogger* logger = &appState->logger;
+  puint32     dropped;
+  pbool       drained = 0;
+
+  for (;;) {
+    PostLogSlot* slot = &logger->slots[logger->tail & POST_LOG_RING_MASK];
+
+    if (atomic_load_explicit(&slot->sequence, memory_order_acquire) !=
+        logger->tail + 1)
+      break;
+
+    PostLogDeliver(appState, slot->level, slot->message);
+
+    atomic_store_explicit(
+      &slot->sequence, logger->tail + POST_LOG_RING_SIZE, memory_order_release);
+
+    ++logger->tail;
+    drained = 1;
+  }
+
+  dropped = atomic_exchange_explicit(&logger->dropped, 0, memory_order_relaxed);
+
+  if (dropped) {
+    char message[64];
+    snprintf(message,
+             sizeof(message),
+             "Log Ring Full: Dropped %u Messages",
+             (unsigned) dropped);
+    PostLogDeliver(appState, POST_LOG_LEVEL_WARNING, message);
+  }
+
+  return drained;
+}
+
+static void
+PostLogThread(void* arg)
+{
+  PostAppState* appState = arg;
+  PostLogger*   logger   = &appState->logger;
+
+  while (atomic_load_explicit(&logger->running, memory_order_acquire)) {
+    PostEventWait(logger->wake);
+    PostLogDrain(appState);
+  }
+
+  // NOTE: deliver whatever was published before the stop
+  while (PostLogDrain(appState))
+    ;
+}
+
+void
+PostLoggerInit(PostLogger* logger)
+{
+  atomic_init(&logger->head, 0);
+  atomic_init(&logger->dropped, 0);
+  atomic_init(&logger->running, 0);
+
+  logger->tail   = 0;
+  logger->thread = NULL;
+  logger->wake   = NULL;
+
+  for (puint32 i = 0; i < POST_LOG_RING_SIZE; ++i)
+    atomic_init(&logger->slots[i].sequence, i);
+}
+
+PostError
+PostAppStartLogging(PostAppState* appState)
+{
+  PostLogger* logger = &appState->logger;
+  PostError   error;
+
+  if (logger->thread != NULL)
+    return POST_ERR_NONE;
+
+  PostTry(PostEventCreate(&logger->wake));
+
+  atomic_store_explicit(&logger->running, 1, memory_order_release);
+
+  error = PostThreadCreate(&logger->thread, PostLogThread, appState);
+
+  if (error != POST_ERR_NONE) {
+    atomic_store_explicit(&logger->running, 0, memory_order_release);
+    PostEventDestroy(logger->wake);
+    logger->thread = NULL;
+    logger->wake   = NULL;
+  }
+
+  return error;
+}
+
+void
+PostAppStopLogging(PostAppState* appState)
+{
+  PostLogger* logger = &appState->logger;
+
+  if (logger->thread == NULL)
+    return;
+
+  atomic_store_explicit(&logger->running, 0, memory_order_release);
+  PostEventSignal(logger->wake);
+  PostThreadJoin(logger->thread);
+  PostEventDestroy(logger->wake);
+
+  logger->thread = NULL;
+  logger->wake   = NULL;
+}
+
+void
+PostAppLogWrite(PostAppState* appState,
+                PostLogSite*  site,
+                puint8        level,
+                const char*   fmt,
+                ...)
+{
+  puint64 now = PostTimeNanos();
+  va_list args;
+
+  if (now - site->windowStart >= POST_LOG_SITE_WINDOW) {
+    if (site->suppressed)
+      PostLogPushFormat(appState,
+                        level,
+                        "Suppressed %u Messages Like: '%s'",
+                        (unsigned) site->suppressed,
+                        fmt);
+
+    site->windowStart = now;
+    site->count       = 0;
+    site->suppressed  = 0;
+  }
+
+  if (site->count == POST_LOG_SITE_BURST) {
+    ++site->suppressed;
+    return;
+  }
+
+  ++site->count;
+
+  va_start(args, fmt);
+  PostLogPush(appState, level, fmt, args);
+  va_end(args);
+}
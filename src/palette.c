@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "post/palette.h"
+#include "post/unicode.h"
+
+// match xterm colors
+static const PostColor ansiColors[16] = {
+  PostColorRGB(0, 0, 0),       PostColorRGB(205, 0, 0),
+  PostColorRGB(0, 205, 0),     PostColorRGB(205, 205, 0),
+  PostColorRGB(0, 0, 238),     PostColorRGB(205, 0, 205),
+  PostColorRGB(0, 205, 205),   PostColorRGB(229, 229, 229),
+  PostColorRGB(127, 127, 127), PostColorRGB(255, 0, 0),
+  PostColorRGB(0, 255, 0),     PostColorRGB(255, 255, 0),
+  PostColorRGB(92, 92, 255),   PostColorRGB(255, 0, 255),
+  PostColorRGB(0, 255, 255),   PostColorRGB(255, 255, 255),
+};
+
+static const puint8 cubeLevels[6] = { 0, 95, 135, 175, 215, 255 };
+
+void
+PostPaletteInit(PostPalette* palette, PostColor fg, PostColor bg)
+{
+  for (puint32 i = 0; i < POST_PALETTE_SIZE; ++i)
+    palette->colors[i] = PostPaletteDefaultColor(i);
+
+  palette->fg = fg;
+  palette->bg = bg;
+}
+
+PostColor
+PostPaletteDefaultColor(puint8 index)
+{
+  puint8 level;
+
+  if (index < 16)
+    return ansiColors[index];
+
+  if (index < 232) {
+    index -= 16;
+    return (PostColor) PostColorRGB(cubeLevels[index / 36],
+                                    cubeLevels[index / 6 % 6],
+                                    cubeLevels[index % 6]);
+  }
+
+  level = 8 + (index - 232) * 10;
+  return (PostColor) PostColorXXX(level);
+}
+
+static int
+PostPaletteHexDigit(puint8 ch)
+{
+  if (ch >= POST_UNICODE_0 && ch <= POST_UNICODE_9)
+    return ch - POST_UNICODE_0;
+  if (ch >= POST_UNICODE_a && ch <= POST_UNICODE_f)
+    return ch - POST_UNICODE_a + 10;
+  if (ch >= POST_UNICODE_A && ch <= POST_UNICODE_F)
+    return ch - POST_UNICODE_A + 10;
+  return -1;
+}
+
+/**
+ * reads 1 to 4 hex digits from spec into a 16-bit component, scaled when
+ * scale is set ("rgb:f/0/0" is full red) and left aligned otherwise
+ * ("#f00" is 0xF000 red)
+ */
+static PostError
+PostPaletteParseComponent(const puint8* spec,
+                          pusize        len,
+                          pbool         scale,
+                          puint32*      component)
+{
+  puint32 value = 0;
+
+  if (!len || len > 4)
+    return POST_ERR_BAD_ARG;
+
+  for (pusize i = 0; i < len; ++i) {
+    int digit = PostPaletteHexDigit(spec[i]);
+
+    if (digit < 0)
+      return POST_ERR_BAD_ARG;
+
+    value = value << 4 | digit;
+  }
+
+  if (scale)
+    *component = value * 0xFFFF / ((1u << (len * 4)) - 1);
+  else
+    *component = value << (16 - len * 4);
+
+  return POST_ERR_NONE;
+}
+
+PostError
+PostPaletteParseColor(const puint8* spec, pusize len, PostColor* color)
+{
+  puint32 rgb[3];
+
+  if (len > 1 && spec[0] == POST_UNICODE_NUMBER_SIGN) {
+    pusize digits = len - 1;
+
+    if (digits % 3)
+      return POST_ERR_BAD_ARG;
+
+    digits /= 3;
+
+    for (pusize i = 0; i < 3; ++i)
+      PostTry(PostPaletteParseComponent(
+        spec + 1 + i * digits, digits, 0, rgb + i));
+  } else if (len > 4 && spec[0] == POST_UNICODE_r &&
+             spec[1] == POST_UNICODE_g && spec[2] == POST_UNICODE_b &&
+             spec[3] == POST_UNICODE_COLON) {
+    pusize start = 4, i = 0;
+
+    for (pusize end = start; end <= len; ++end) {
+      if (end < len && spec[end] != POST_UNICODE_SLASH)
+        continue;
+
+      if (i == 3)
+        return POST_ERR_BAD_ARG;
+
+      PostTry(
+        PostPaletteParseComponent(spec + start, end - start, 1, rgb + i++));
+      start = end + 1;
+    }
+
+    if (i != 3)
+      return POST_ERR_BAD_ARG;
+  } else
+    return POST_ERR_UNSUPPORTED;
+
+  *color = (PostColor) PostColorRGB(rgb[0] >> 8, rgb[1] >> 8, rgb[2] >> 8);
+
+  return POST_ERR_NONE;
+}
+
+pusize
+PostPaletteFormatColor(PostColor color, char* buf)
+{
+  static const char hex[] = "0123456789abcdef";
+  puint8            components[3] = { color.r, color.g, color.b };
+  pusize            n             = 0;
+
+  buf[n++] = 'r';
+  buf[n++] = 'g';
+  buf[n++] = 'b';
+
+  // NOTE: 8-bit components are widened the way X11 does, 0xAB to 0xABAB
+  for (pusize i = 0; i < 3; ++i) {
+    buf[n++] = i ? '/' : ':';
+
+    for (int j = 0; j < 2; ++j) {
+      buf[n++] = hex[components[i] >> 4];
+      buf[n++] = hex[components[i] & 0xF];
+    }
+  }
+
+  return n;
+}
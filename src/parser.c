@@ -20,112 +20,85 @@
  * IN THE SOFTWARE.
  */
 
-#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "post/app.h"
 #include "post/color.h"
 #include "post/compiler.h"
+#include "post/palette.h"
 #include "post/parser.h"
+#include "post/scan.h"
 #include "post/unicode.h"
-
-// match xterm colors
-static PostColor sgrColors[16] = {
-  PostColorRGB(0, 0, 0),       PostColorRGB(205, 0, 0),
-  PostColorRGB(0, 205, 0),     PostColorRGB(205, 205, 0),
-  PostColorRGB(0, 0, 238),     PostColorRGB(205, 0, 205),
-  PostColorRGB(0, 205, 205),   PostColorRGB(229, 229, 229),
-  PostColorRGB(127, 127, 127), PostColorRGB(255, 0, 0),
-  PostColorRGB(0, 255, 0),     PostColorRGB(255, 255, 0),
-  PostColorRGB(92, 92, 255),   PostColorRGB(255, 0, 255),
-  PostColorRGB(0, 255, 255),   PostColorRGB(255, 255, 255),
-};
-
-#define PostAttributesIterate(ATTRIBS)                                         \
-  for (PostAttribute* current = (ATTRIBS),                                     \
-                      *tmp    = ((void) (current != NULL &&                    \
-                                      ((current = current->prev),           \
-                                       ((ATTRIBS)->prev = NULL))),          \
-                              current);                                     \
-       current != NULL;                                                        \
-       current = current->prev, tmp = (free(tmp), current))
-
-#define PostGetCell(X, Y) appState->grid.cells[(Y) * appState->grid.width + (X)]
+#include "post/vttable.h"
+#include "post/width.h"
 
 #define PostGridWidth()  appState->grid.width
 #define PostGridHeight() appState->grid.height
 
 typedef void (*PostCommand1)(PostAppState*, PostCursor*, puint32);
-typedef void (*PostCommand2)(PostAppState*, PostCursor*, puint32, puint32);
-
-typedef struct
-{
-  puint32 defaultValue;
-} PostArg;
-
-typedef struct
-{
-  /**
-   * 1 - accept any args (MUL)
-   * 2 - accept up to one args
-   * 3 - accept up to two args
-   */
-  puint8 type;
-
-  union
-  {
-    struct
-    {
-      PostArg      arg;
-      PostCommand1 command;
-    } one_arg;
-    struct
-    {
-      PostArg      args[2];
-      PostCommand2 command;
-    } two_args;
-  };
-} PostCommand;
 
 #define DefinePostCommandMul(NAME) DefinePostCommand1(NAME)
 #define DefinePostCommand1(NAME)                                               \
-  void PostCommand##NAME(                                                      \
+  static void PostCommand##NAME(                                               \
     UNUSED PostAppState* appState, UNUSED PostCursor* cursor, puint32 arg)
 #define DefinePostCommand2(NAME)                                               \
-  void PostCommand##NAME(UNUSED PostAppState* appState,                        \
-                         UNUSED PostCursor*   cursor,                          \
-                         puint32              arg1,                            \
-                         puint32              arg2)
-
-#define PostCommandMulStruct(NAME, DEFAULT_VALUE)                              \
-  {                                                                            \
-    .type = 1, .one_arg = {                                                    \
-      .arg     = { .defaultValue = (DEFAULT_VALUE) },                          \
-      .command = PostCommand##NAME,                                            \
-    }                                                                          \
-  }
-
-#define PostCommand1Struct(NAME, DEFAULT_VALUE)                                \
-  {                                                                            \
-    .type = 2, .one_arg = {                                                    \
-      .arg     = { .defaultValue = (DEFAULT_VALUE) },                          \
-      .command = PostCommand##NAME,                                            \
-    }                                                                          \
-  }
-
-#define PostCommand2Struct(NAME, DEFAULT_VALUE1, DEFAULT_VALUE2)               \
-  {                                                                            \
-    .type = 3, \
-    .two_args = {                                                   \
-      .args    = { \
-          { .defaultValue = (DEFAULT_VALUE1) }, \
-          { .defaultValue = (DEFAULT_VALUE2), }, \
-        }, \
-      .command = PostCommand##NAME, \
-    }                                                               \
-  }
+  static void PostCommand##NAME(UNUSED PostAppState* appState,                 \
+                                UNUSED PostCursor*   cursor,                   \
+                                puint32              arg1,                     \
+                                puint32              arg2)
 
 DefinePostCommand1(ICH)
 {
+  PostCell* row;
+  puint32*  blankFrom = PostGridBlankFrom(&appState->grid, cursor->y);
+  puint32   end;
+
+  if (!arg)
+    arg = 1;
+
+  cursor->lastColumnFlag = 0;
+
+  if (cursor->x + arg > PostGridWidth())
+    arg = PostGridWidth() - cursor->x;
+
+  // NOTE: inserting blanks into the blank part of a row changes nothing
+  if (cursor->x >= *blankFrom)
+    return;
+
+  row = PostGridRow(&appState->grid, cursor->y);
+  end = *blankFrom;
+
+  // NOTE: a wide character split by the insertion or cut off at the end of
+  // the row is blanked
+  PostAppSplitWide(appState, cursor->y, cursor->x, cursor->x);
+
+  if (end > PostGridWidth() - arg) {
+    PostAppSplitWide(appState,
+                     cursor->y,
+                     PostGridWidth() - arg,
+                     PostGridWidth() - arg);
+    PostAppReleaseCells(
+      appState, row + PostGridWidth() - arg, end - (PostGridWidth() - arg));
+    end = PostGridWidth() - arg;
+  }
+
+  // NOTE: the cells left behind were moved, not copied, so they hold no
+  // references of their own
+  memmove(row + cursor->x + arg,
+          row + cursor->x,
+          (end - cursor->x) * sizeof(*row));
+  memset(row + cursor->x, 0, arg * sizeof(*row));
+
+  *blankFrom = end + arg;
+  PostGridDamage(&appState->grid, cursor->y, cursor->x, *blankFrom);
+}
+
+DefinePostCommand1(DCH)
+{
+  PostCell* row;
+  puint32*  blankFrom = PostGridBlankFrom(&appState->grid, cursor->y);
+
   if (!arg)
     arg = 1;
 
@@ -134,11 +107,39 @@ DefinePostCommand1(ICH)
   if (cursor->x + arg > PostGridWidth())
     arg = PostGridWidth() - cursor->x;
 
-  for (puint32 x = PostGridWidth() - 1; x >= cursor->x + arg; --x)
-    PostGetCell(x, cursor->y) = PostGetCell(x - arg, cursor->y);
+  if (cursor->x >= *blankFrom)
+    return;
+
+  PostAppSplitWide(appState, cursor->y, cursor->x, cursor->x + arg);
+
+  // NOTE: deleting up to the blank part of a row only moves the marker
+  if (cursor->x + arg >= *blankFrom) {
+    PostAppEraseCells(appState, cursor->y, cursor->x, PostGridWidth());
+    return;
+  }
+
+  row = PostGridRow(&appState->grid, cursor->y);
 
-  for (puint32 x = cursor->x; x < cursor->x + arg; ++x)
-    PostGetCell(x, cursor->y).charCode = 0;
+  PostAppReleaseCells(appState, row + cursor->x, arg);
+  memmove(row + cursor->x,
+          row + cursor->x + arg,
+          (*blankFrom - cursor->x - arg) * sizeof(*row));
+
+  PostGridDamage(&appState->grid, cursor->y, cursor->x, *blankFrom);
+  *blankFrom -= arg;
+}
+
+DefinePostCommand1(ECH)
+{
+  if (!arg)
+    arg = 1;
+
+  cursor->lastColumnFlag = 0;
+
+  if (cursor->x + arg > PostGridWidth())
+    arg = PostGridWidth() - cursor->x;
+
+  PostAppEraseCells(appState, cursor->y, cursor->x, cursor->x + arg);
 }
 
 DefinePostCommand1(CUU)
@@ -215,11 +216,22 @@ DefinePostCommand1(CHA)
 {
   if (!arg)
     arg = 1;
+  else if (arg > PostGridWidth())
+    arg = PostGridWidth();
+
+  cursor->lastColumnFlag = 0;
+  cursor->x              = arg - 1;
+}
 
-  if (arg >= PostGridWidth())
-    arg = PostGridWidth() - 1;
+DefinePostCommand1(VPA)
+{
+  if (!arg)
+    arg = 1;
+  else if (arg > PostGridHeight())
+    arg = PostGridHeight();
 
-  cursor->x = arg;
+  cursor->lastColumnFlag = 0;
+  cursor->y              = arg - 1;
 }
 
 DefinePostCommand2(CUP)
@@ -252,70 +264,187 @@ DefinePostCommand1(CHT)
     cursor->x = PostGridWidth() - 1;
 }
 
-DefinePostCommand1(ED)
+DefinePostCommand1(CBT)
 {
-  PostCell defaultCell = {
-    .fg = appState->config.fg,
-    .bg = appState->config.bg,
-  };
+  puint32 tabWidth = appState->config.tabWidth;
+  if (!arg)
+    arg = 1;
+  cursor->lastColumnFlag = 0;
+  // back to the previous tab stop, then a whole tab for each one after it
+  cursor->x = (cursor->x + tabWidth - 1) / tabWidth * tabWidth;
+  if (arg * tabWidth >= cursor->x)
+    cursor->x = 0;
+  else
+    cursor->x -= arg * tabWidth;
+}
 
+DefinePostCommand1(ED)
+{
   cursor->lastColumnFlag = 0;
 
   if (arg == 0) {
-    for (puint32 x = cursor->x; x < PostGridWidth(); ++x)
-      PostGetCell(x, cursor->y) = defaultCell;
+    PostAppEraseCells(appState, cursor->y, cursor->x, PostGridWidth());
 
     for (puint32 y = cursor->y + 1; y < PostGridHeight(); ++y)
-      for (puint32 x = 0; x < PostGridWidth(); ++x)
-        PostGetCell(x, y) = defaultCell;
+      PostAppEraseCells(appState, y, 0, PostGridWidth());
   } else if (arg == 1) {
     for (puint32 y = 0; y < cursor->y; ++y)
-      for (puint32 x = 0; x < PostGridWidth(); ++x)
-        PostGetCell(x, y) = defaultCell;
-
-    for (puint32 x = 0; x < cursor->x; ++x)
-      PostGetCell(x, cursor->y) = defaultCell;
-  } else if (arg == 2 || arg == 3) {
-    // FIXME: also clear scrollback buffer on attrib == 3 once we implement
-    // scrollback
+      PostAppEraseCells(appState, y, 0, PostGridWidth());
+
+    PostAppEraseCells(appState, cursor->y, 0, cursor->x);
+  } else if (arg == 2) {
     for (puint32 y = 0; y < PostGridHeight(); ++y)
-      for (puint32 x = 0; x < PostGridWidth(); ++x)
-        PostGetCell(x, y) = defaultCell;
+      PostAppEraseCells(appState, y, 0, PostGridWidth());
+  } else if (arg == 3) {
+    // NOTE: like xterm this erases the saved lines and leaves the screen
+    PostScrollbackClear(appState);
   } else
     PostAppLogWarning(appState, "Invalid Erase in Display Argument: %u", arg);
 }
 
 DefinePostCommand1(EL)
 {
-  puint32  start, end;
-  PostCell defaultCell = {
-    .fg = appState->config.fg,
-    .bg = appState->config.bg,
-  };
-
   cursor->lastColumnFlag = 0;
 
-  if (arg == 0) {
-    start = cursor->x;
-    end   = PostGridWidth();
-  } else if (arg == 1) {
-    start = 0;
-    end   = cursor->x;
-  } else if (arg == 2) {
-    start = 0;
-    end   = PostGridWidth();
-  } else {
+  if (arg == 0)
+    PostAppEraseCells(appState, cursor->y, cursor->x, PostGridWidth());
+  else if (arg == 1)
+    PostAppEraseCells(appState, cursor->y, 0, cursor->x);
+  else if (arg == 2)
+    PostAppEraseCells(appState, cursor->y, 0, PostGridWidth());
+  else
     PostAppLogWarning(appState, "Invalid Erase in Line Argument: %u", arg);
+}
+
+DefinePostCommand1(IL)
+{
+  if (!arg)
+    arg = 1;
+
+  if (cursor->y < appState->scrollTop || cursor->y > appState->scrollBottom)
+    return;
+
+  cursor->lastColumnFlag = 0;
+  cursor->x              = 0;
+
+  PostAppScrollDown(appState, cursor->y, appState->scrollBottom, arg);
+}
+
+DefinePostCommand1(DL)
+{
+  if (!arg)
+    arg = 1;
+
+  if (cursor->y < appState->scrollTop || cursor->y > appState->scrollBottom)
+    return;
+
+  cursor->lastColumnFlag = 0;
+  cursor->x              = 0;
+
+  PostAppScrollUp(appState, cursor->y, appState->scrollBottom, arg);
+}
+
+DefinePostCommand1(SU)
+{
+  if (!arg)
+    arg = 1;
+
+  PostAppScrollUp(appState, appState->scrollTop, appState->scrollBottom, arg);
+}
+
+DefinePostCommand1(SD)
+{
+  if (!arg)
+    arg = 1;
+
+  PostAppScrollDown(
+    appState, appState->scrollTop, appState->scrollBottom, arg);
+}
+
+DefinePostCommand1(REP)
+{
+  puint32 codepoint = appState->parser.lastCodepoint;
+
+  if (!codepoint)
     return;
+
+  if (!arg)
+    arg = 1;
+
+  // NOTE: the copies are written a buffer at a time so the repeat costs about
+  // the same as the child sending them
+  if (codepoint < 0x80) {
+    puint8 run[256];
+
+    memset(run, codepoint, arg < sizeof(run) ? arg : sizeof(run));
+
+    for (puint32 n; arg; arg -= n) {
+      n = arg < sizeof(run) ? arg : sizeof(run);
+      PostAppWriteASCII(appState, cursor, run, n);
+    }
+  } else {
+    puint32 run[64];
+
+    for (puint32 i = 0; i < arg && i < sizeof(run) / sizeof(*run); ++i)
+      run[i] = codepoint;
+
+    for (puint32 n; arg; arg -= n) {
+      n = arg < sizeof(run) / sizeof(*run) ? arg : sizeof(run) / sizeof(*run);
+      PostAppWriteCodepoints(appState, cursor, run, n);
+    }
   }
+}
+
+DefinePostCommand2(DECSTBM)
+{
+  if (!arg1)
+    arg1 = 1;
+
+  if (!arg2 || arg2 > PostGridHeight())
+    arg2 = PostGridHeight();
+
+  // NOTE: like xterm a region of less than two rows is ignored
+  if (arg1 >= arg2)
+    return;
+
+  appState->scrollTop    = arg1 - 1;
+  appState->scrollBottom = arg2 - 1;
+
+  cursor->lastColumnFlag = 0;
+  cursor->x              = 0;
+  cursor->y              = 0;
+}
+
+static inline void
+PostParserSetAltScreen(PostAppState* appState,
+                       PostCursor*   cursor,
+                       pbool         alt,
+                       pbool         clear)
+{
+  PostError error = PostAppSetAltScreen(appState, cursor, alt, clear);
 
-  for (; start < end; ++start)
-    PostGetCell(start, cursor->y) = defaultCell;
+  if (error != POST_ERR_NONE)
+    PostAppLogWarning(
+      appState, "Failed to Switch Screens: %s", PostErrorString(error));
 }
 
+// NOTE: 47 only switches screens, 1047 also clears the alternate screen on
+// the way out and 1049 saves the cursor and clears it on the way in
 DefinePostCommand1(DECSET)
 {
   switch (arg) {
+    case 47:
+    case 1047:
+      PostParserSetAltScreen(appState, cursor, 1, 0);
+      break;
+    case 1048:
+      PostAppSaveCursor(appState, cursor);
+      break;
+    case 1049:
+      if (!appState->altScreen)
+        PostAppSaveCursor(appState, cursor);
+      PostParserSetAltScreen(appState, cursor, 1, 1);
+      break;
     case 2004:
       appState->config.bracketedPasteMode = 1;
       break;
@@ -328,6 +457,21 @@ DefinePostCommand1(DECSET)
 DefinePostCommand1(DECRST)
 {
   switch (arg) {
+    case 47:
+      PostParserSetAltScreen(appState, cursor, 0, 0);
+      break;
+    case 1047:
+      PostParserSetAltScreen(appState, cursor, 0, 1);
+      break;
+    case 1048:
+      PostAppRestoreCursor(appState, cursor);
+      break;
+    case 1049:
+      if (appState->altScreen) {
+        PostParserSetAltScreen(appState, cursor, 0, 0);
+        PostAppRestoreCursor(appState, cursor);
+      }
+      break;
     case 2004:
       appState->config.bracketedPasteMode = 0;
       break;
@@ -341,69 +485,67 @@ DefinePostCommandMul(SGR)
 {
   switch (arg) {
     case 0:
-      cursor->fg  = appState->config.fg;
-      cursor->bg  = appState->config.bg;
-      cursor->sgr = 0;
+      cursor->attrs = appState->styles.defaultStyle;
       break;
     case 1:
-      cursor->sgr &= ~POST_CELL_SGR_FAINT;
-      cursor->sgr |= POST_CELL_SGR_BOLD;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_FAINT;
+      cursor->attrs.sgr |= POST_CELL_SGR_BOLD;
       break;
     case 2:
-      cursor->sgr &= ~POST_CELL_SGR_BOLD;
-      cursor->sgr |= POST_CELL_SGR_FAINT;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_BOLD;
+      cursor->attrs.sgr |= POST_CELL_SGR_FAINT;
       break;
     case 3:
-      cursor->sgr |= POST_CELL_SGR_ITALIC;
+      cursor->attrs.sgr |= POST_CELL_SGR_ITALIC;
       break;
     case 4:
-      cursor->sgr &= ~POST_CELL_SGR_DBL_UNDERLINE;
-      cursor->sgr |= POST_CELL_SGR_UNDERLINE;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_DBL_UNDERLINE;
+      cursor->attrs.sgr |= POST_CELL_SGR_UNDERLINE;
       break;
     case 5:
-      cursor->sgr &= ~POST_CELL_SGR_RAPID_BLINK;
-      cursor->sgr |= POST_CELL_SGR_SLOW_BLINK;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_RAPID_BLINK;
+      cursor->attrs.sgr |= POST_CELL_SGR_SLOW_BLINK;
       break;
     case 6:
-      cursor->sgr &= ~POST_CELL_SGR_SLOW_BLINK;
-      cursor->sgr |= POST_CELL_SGR_RAPID_BLINK;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_SLOW_BLINK;
+      cursor->attrs.sgr |= POST_CELL_SGR_RAPID_BLINK;
       break;
     case 7:
-      cursor->sgr |= POST_CELL_SGR_INVERT;
+      cursor->attrs.sgr |= POST_CELL_SGR_INVERT;
       break;
     case 8:
-      cursor->sgr |= POST_CELL_SGR_CONCEAL;
+      cursor->attrs.sgr |= POST_CELL_SGR_CONCEAL;
       break;
     case 9:
-      cursor->sgr |= POST_CELL_SGR_STRIKE;
+      cursor->attrs.sgr |= POST_CELL_SGR_STRIKE;
       break;
     case 21:
-      cursor->sgr &= ~POST_CELL_SGR_UNDERLINE;
-      cursor->sgr |= POST_CELL_SGR_DBL_UNDERLINE;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_UNDERLINE;
+      cursor->attrs.sgr |= POST_CELL_SGR_DBL_UNDERLINE;
       break;
     case 22:
-      cursor->sgr &= ~POST_CELL_SGR_BOLD;
-      cursor->sgr &= ~POST_CELL_SGR_FAINT;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_BOLD;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_FAINT;
       break;
     case 23:
-      cursor->sgr &= ~POST_CELL_SGR_ITALIC;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_ITALIC;
       break;
     case 24:
-      cursor->sgr &= ~POST_CELL_SGR_UNDERLINE;
-      cursor->sgr &= ~POST_CELL_SGR_DBL_UNDERLINE;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_UNDERLINE;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_DBL_UNDERLINE;
       break;
     case 25:
-      cursor->sgr &= ~POST_CELL_SGR_SLOW_BLINK;
-      cursor->sgr &= ~POST_CELL_SGR_RAPID_BLINK;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_SLOW_BLINK;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_RAPID_BLINK;
       break;
     case 27:
-      cursor->sgr &= ~POST_CELL_SGR_INVERT;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_INVERT;
       break;
     case 28:
-      cursor->sgr &= ~POST_CELL_SGR_CONCEAL;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_CONCEAL;
       break;
     case 29:
-      cursor->sgr &= ~POST_CELL_SGR_STRIKE;
+      cursor->attrs.sgr &= ~POST_CELL_SGR_STRIKE;
       break;
     case 30:
     case 31:
@@ -413,10 +555,10 @@ DefinePostCommandMul(SGR)
     case 35:
     case 36:
     case 37:
-      cursor->fg = sgrColors[arg - 30];
+      cursor->attrs.fg = PostColorRefPalette(arg - 30);
       break;
     case 39:
-      cursor->fg = appState->config.fg;
+      cursor->attrs.fg = POST_COLOR_REF_DEFAULT;
       break;
     case 40:
     case 41:
@@ -426,10 +568,13 @@ DefinePostCommandMul(SGR)
     case 45:
     case 46:
     case 47:
-      cursor->bg = sgrColors[arg - 40];
+      cursor->attrs.bg = PostColorRefPalette(arg - 40);
       break;
     case 49:
-      cursor->bg = appState->config.bg;
+      cursor->attrs.bg = POST_COLOR_REF_DEFAULT;
+      break;
+    case 59:
+      cursor->attrs.ul = POST_COLOR_REF_DEFAULT;
       break;
     case 90:
     case 91:
@@ -439,7 +584,7 @@ DefinePostCommandMul(SGR)
     case 95:
     case 96:
     case 97:
-      cursor->fg = sgrColors[arg - 90 + 8];
+      cursor->attrs.fg = PostColorRefPalette(arg - 90 + 8);
       break;
     case 100:
     case 101:
@@ -449,7 +594,7 @@ DefinePostCommandMul(SGR)
     case 105:
     case 106:
     case 107:
-      cursor->bg = sgrColors[arg - 100 + 8];
+      cursor->attrs.bg = PostColorRefPalette(arg - 100 + 8);
       break;
     default:
       PostAppLogWarning(appState, "Invalid SGR Argument: %u", arg);
@@ -457,149 +602,945 @@ DefinePostCommandMul(SGR)
   }
 }
 
-static PostCommand commands[128] = {
-  [POST_UNICODE_AT_SIGN] = PostCommand1Struct(ICH, 1),
-  [POST_UNICODE_A]       = PostCommand1Struct(CUU, 1),
-  [POST_UNICODE_B]       = PostCommand1Struct(CUD, 1),
-  [POST_UNICODE_C]       = PostCommand1Struct(CUF, 1),
-  [POST_UNICODE_D]       = PostCommand1Struct(CUB, 1),
-  [POST_UNICODE_E]       = PostCommand1Struct(CNL, 1),
-  [POST_UNICODE_F]       = PostCommand1Struct(CPL, 1),
-  [POST_UNICODE_G]       = PostCommand1Struct(CHA, 1),
-  [POST_UNICODE_H]       = PostCommand2Struct(CUP, 1, 1),
-  [POST_UNICODE_I]       = PostCommand1Struct(CHT, 1),
-  [POST_UNICODE_J]       = PostCommand1Struct(ED, 0),
-  [POST_UNICODE_K]       = PostCommand1Struct(EL, 0),
-  [POST_UNICODE_m]       = PostCommandMulStruct(SGR, 0),
-  // TODO: CUP
-};
+static void
+PostParserClear(PostParser* parser)
+{
+  parser->privateMarker    = 0;
+  parser->numIntermediates = 0;
+  parser->numParams        = 0;
+  parser->paramsFull       = 0;
+  parser->subParams        = 0;
+  parser->emptyParams      = 0;
+}
 
-static PostCommand privateCommands[128] = {
-  [POST_UNICODE_h] = PostCommand1Struct(DECSET, 0),
-  [POST_UNICODE_l] = PostCommand1Struct(DECRST, 0),
-};
+static void
+PostParserNextParam(PostParser* parser, pbool isSubParam)
+{
+  puint8 n = parser->numParams;
 
-void
-PostParseCSI(PostAppState* appState, PostCursor* cursor, char ch)
+  if (n == POST_PARSER_MAX_PARAMS) {
+    parser->paramsFull = 1;
+    return;
+  }
+
+  parser->params[n] = 0;
+  parser->emptyParams |= (puint32) 1 << n;
+
+  if (isSubParam)
+    parser->subParams |= (puint32) 1 << n;
+
+  parser->numParams = n + 1;
+}
+
+static inline pbool
+PostParserIsSubParam(PostParser* parser, puint8 i)
 {
-  if (appState->parser.attribs == NULL && ch == POST_UNICODE_QUESTION_MARK) {
-    appState->parser.isPrivate = 1;
+  return (parser->subParams >> i) & 1;
+}
+
+static inline puint32
+PostParserGetParam(PostParser* parser, puint8 i, puint32 defaultValue)
+{
+  if (i >= parser->numParams || (parser->emptyParams >> i) & 1)
+    return defaultValue;
+  return parser->params[i];
+}
+
+static void
+PostParserParam(PostParser* parser, puint8 ch)
+{
+  puint8  i;
+  puint32 n;
+
+  if (ch == POST_UNICODE_SEMICOLON || ch == POST_UNICODE_COLON) {
+    if (!parser->numParams)
+      PostParserNextParam(parser, 0);
+    PostParserNextParam(parser, ch == POST_UNICODE_COLON);
     return;
   }
 
-  if (ch >= POST_UNICODE_0 && ch <= POST_UNICODE_9) {
-    PostAttribute* currentAttrib = appState->parser.currentAttrib;
-    PostAttribute* head          = appState->parser.attribs;
+  if (!parser->numParams)
+    PostParserNextParam(parser, 0);
 
-    if (currentAttrib == NULL) {
-      PostAttribute* attrib = malloc(sizeof(PostAttribute));
+  if (parser->paramsFull)
+    return;
 
-      if (attrib == NULL) {
-        PostAppLogWarning(appState, "Ignoring CSI Attribute: Out Of Memory");
-        return;
-      }
+  i = parser->numParams - 1;
+  n = parser->params[i] * 10 + (ch - POST_UNICODE_0);
 
-      memset(attrib, 0, sizeof(PostAttribute));
+  parser->params[i] = n > POST_PARSER_MAX_PARAM ? POST_PARSER_MAX_PARAM : n;
+  parser->emptyParams &= ~((puint32) 1 << i);
+}
 
-      if (head == NULL) {
-        attrib->prev = attrib;
-        attrib->next = attrib;
-      } else {
-        attrib->prev     = head->prev;
-        attrib->next     = head;
-        head->prev->next = attrib;
-        head->prev       = attrib;
-      }
+static void
+PostParserCollect(PostParser* parser, puint8 ch)
+{
+  // NOTE: private markers (0x3C - 0x3F) may only lead the parameters
+  if (ch >= POST_UNICODE_LESS_THAN && !parser->numParams &&
+      !parser->numIntermediates && !parser->privateMarker) {
+    parser->privateMarker = ch;
+    return;
+  }
+
+  if (parser->numIntermediates < POST_PARSER_MAX_INTERMEDIATES)
+    parser->intermediates[parser->numIntermediates] = ch;
+
+  // NOTE: one past the maximum marks the sequence as unsupported
+  if (parser->numIntermediates <= POST_PARSER_MAX_INTERMEDIATES)
+    ++parser->numIntermediates;
+}
+
+/**
+ * (private marker, intermediate, final byte) packed into a switch key, only
+ * sequences with at most one intermediate are dispatched
+ */
+#define PostParserKey(PRIVATE, INTERMEDIATE, FINAL)                            \
+  (((puint32) (PRIVATE) << 16) | ((puint32) (INTERMEDIATE) << 8) | (FINAL))
+
+static inline puint32
+PostParserGetKey(PostParser* parser, puint8 final)
+{
+  puint8 intermediate =
+    parser->numIntermediates == 1 ? parser->intermediates[0] : 0;
+  return PostParserKey(parser->privateMarker, intermediate, final);
+}
+
+static void
+PostParserDispatchMul(PostAppState* appState,
+                      PostCursor*   cursor,
+                      PostCommand1  command,
+                      puint32       defaultValue)
+{
+  PostParser* parser = &appState->parser;
+
+  if (!parser->numParams)
+    command(appState, cursor, defaultValue);
+
+  // NOTE: sub-parameters are only meaningful to commands that look at the
+  // whole parameter list themselves
+  for (puint8 i = 0; i < parser->numParams; ++i)
+    if (!PostParserIsSubParam(parser, i))
+      command(appState, cursor, PostParserGetParam(parser, i, defaultValue));
+}
 
-      currentAttrib                  = attrib;
-      appState->parser.currentAttrib = attrib;
-      head                           = attrib;
-      appState->parser.attribs       = attrib;
+/**
+ * reads the colour after SGR 38, 48 or 58 starting at params[i], "5;n" picks
+ * a palette entry and "2;r;g;b" a direct colour, either form may use colons
+ * instead and the colon form of 2 may carry a colour space id before r
+ * ("2::r:g:b"), returns the index of the first parameter after the colour
+ */
+static puint8
+PostParserGetColor(PostParser* parser, puint8 i, PostColorRef* color)
+{
+  puint8  end = parser->numParams;
+  puint32 rgb[3];
+
+  // NOTE: the colon form stops at the end of its sub-parameters so a short
+  // sequence never eats the parameters after it
+  if (i < end && PostParserIsSubParam(parser, i)) {
+    end = i;
+    while (end < parser->numParams && PostParserIsSubParam(parser, end))
+      ++end;
+  }
+
+  if (i >= end)
+    return end;
+
+  switch (PostParserGetParam(parser, i++, 0)) {
+    case 5:
+      if (i >= end)
+        return end;
+
+      if ((rgb[0] = PostParserGetParam(parser, i, 0)) <= 0xFF)
+        *color = PostColorRefPalette(rgb[0]);
+
+      return i + 1;
+    case 2:
+      if (PostParserIsSubParam(parser, i - 1) && end - i >= 4)
+        ++i;
+
+      if (end - i < 3)
+        return end;
+
+      for (puint8 j = 0; j < 3; ++j)
+        if ((rgb[j] = PostParserGetParam(parser, i + j, 0)) > 0xFF)
+          return i + 3;
+
+      *color = PostColorRefRGB(rgb[0], rgb[1], rgb[2]);
+      return i + 3;
+    default:
+      return i;
+  }
+}
+
+static void
+PostParserDispatchSGR(PostAppState* appState, PostCursor* cursor)
+{
+  PostParser* parser = &appState->parser;
+  puint8      i      = 0;
+
+  if (!parser->numParams)
+    PostCommandSGR(appState, cursor, 0);
+
+  while (i < parser->numParams) {
+    puint32 arg = PostParserGetParam(parser, i++, 0);
+
+    switch (arg) {
+      case 38:
+        i = PostParserGetColor(parser, i, &cursor->attrs.fg);
+        break;
+      case 48:
+        i = PostParserGetColor(parser, i, &cursor->attrs.bg);
+        break;
+      case 58:
+        i = PostParserGetColor(parser, i, &cursor->attrs.ul);
+        break;
+      default:
+        PostCommandSGR(appState, cursor, arg);
+        break;
     }
 
-    head->n *= 10;
-    head->n += ch - POST_UNICODE_0;
+    while (i < parser->numParams && PostParserIsSubParam(parser, i))
+      ++i;
+  }
+
+  PostAppUpdateStyle(appState, cursor);
+}
+
+#define PostDispatch1(NAME, DEFAULT_VALUE)                                     \
+  PostCommand##NAME(                                                           \
+    appState, cursor, PostParserGetParam(parser, 0, (DEFAULT_VALUE)))
+
+#define PostDispatch2(NAME, DEFAULT_VALUE1, DEFAULT_VALUE2)                    \
+  PostCommand##NAME(appState,                                                  \
+                    cursor,                                                    \
+                    PostParserGetParam(parser, 0, (DEFAULT_VALUE1)),           \
+                    PostParserGetParam(parser, 1, (DEFAULT_VALUE2)))
+
+#define PostDispatchMul(NAME, DEFAULT_VALUE)                                   \
+  PostParserDispatchMul(appState, cursor, PostCommand##NAME, (DEFAULT_VALUE))
+
+static void
+PostParserDispatchCSI(PostAppState* appState, PostCursor* cursor, puint8 ch)
+{
+  PostParser* parser = &appState->parser;
+
+  PostAppLogDebug(appState, "CSI: %c", ch);
+
+  if (parser->numIntermediates > 1) {
+    PostAppLogWarning(appState, "Unsupported CSI Intermediates: ESC[%c", ch);
     return;
   }
 
-  if (ch == POST_UNICODE_SEMICOLON) {
-    appState->parser.currentAttrib = NULL;
+  switch (PostParserGetKey(parser, ch)) {
+    case PostParserKey(0, 0, POST_UNICODE_AT_SIGN):
+      PostDispatch1(ICH, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_A):
+      PostDispatch1(CUU, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_B):
+      PostDispatch1(CUD, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_C):
+      PostDispatch1(CUF, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_D):
+      PostDispatch1(CUB, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_E):
+      PostDispatch1(CNL, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_F):
+      PostDispatch1(CPL, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_G):
+      PostDispatch1(CHA, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_H):
+    case PostParserKey(0, 0, POST_UNICODE_f): // HVP
+      PostDispatch2(CUP, 1, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_I):
+      PostDispatch1(CHT, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_J):
+      PostDispatch1(ED, 0);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_K):
+      PostDispatch1(EL, 0);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_L):
+      PostDispatch1(IL, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_M):
+      PostDispatch1(DL, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_S):
+      PostDispatch1(SU, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_T):
+      // NOTE: with more parameters this is xterm's mouse highlight tracking
+      if (parser->numParams <= 1)
+        PostDispatch1(SD, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_P):
+      PostDispatch1(DCH, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_X):
+      PostDispatch1(ECH, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_Z):
+      PostDispatch1(CBT, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_GRAVE): // HPA
+      PostDispatch1(CHA, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_a): // HPR
+      PostDispatch1(CUF, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_b):
+      PostDispatch1(REP, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_d):
+      PostDispatch1(VPA, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_e): // VPR
+      PostDispatch1(CUD, 1);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_m):
+      PostParserDispatchSGR(appState, cursor);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_r):
+      PostDispatch2(DECSTBM, 1, 0);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_s): // SCOSC
+      PostAppSaveCursor(appState, cursor);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_u): // SCORC
+      PostAppRestoreCursor(appState, cursor);
+      break;
+    case PostParserKey(POST_UNICODE_QUESTION_MARK, 0, POST_UNICODE_h):
+      PostDispatchMul(DECSET, 0);
+      break;
+    case PostParserKey(POST_UNICODE_QUESTION_MARK, 0, POST_UNICODE_l):
+      PostDispatchMul(DECRST, 0);
+      break;
+    default:
+      PostAppLogWarning(appState,
+                        "Unknown Control Sequence: ESC[%c (Key 0x%06X)",
+                        ch,
+                        PostParserGetKey(parser, ch));
+      break;
+  }
+}
+
+static void
+PostParserDispatchESC(PostAppState* appState, PostCursor* cursor, puint8 ch)
+{
+  PostParser* parser = &appState->parser;
+
+  if (parser->numIntermediates > 1) {
+    PostAppLogWarning(appState, "Unsupported ESC Intermediates: ESC %c", ch);
     return;
   }
 
-  PostAttribute* attribs   = appState->parser.attribs;
-  pbool          isPrivate = appState->parser.isPrivate;
-
-#if 1
-  PostAppLogInfo(appState, "CSI: %c", ch);
-#endif
-
-  if (ch >= 0) {
-    PostCommand command =
-      isPrivate ? privateCommands[(unsigned) ch] : commands[(unsigned) ch];
-
-    if (command.type > 0) {
-      if (command.type == 1) {
-        PostAttributesIterate(attribs) command.one_arg.command(
-          appState,
-          cursor,
-          current->isEmpty ? command.one_arg.arg.defaultValue : current->n);
-      } else if (command.type == 2) {
-        if (attribs == NULL) {
-          command.one_arg.command(
-            appState, cursor, command.one_arg.arg.defaultValue);
-          goto EndCSI;
-        }
+  // NOTE: character set designations are accepted and ignored
+  if (parser->numIntermediates == 1 &&
+      parser->intermediates[0] >= POST_UNICODE_LPAREN &&
+      parser->intermediates[0] <= POST_UNICODE_SLASH)
+    return;
 
-        command.one_arg.command(appState,
-                                cursor,
-                                attribs->prev->isEmpty
-                                  ? command.one_arg.arg.defaultValue
-                                  : attribs->prev->n);
-
-        // NOTE: free attribs
-        PostAttributesIterate(attribs);
-      } else if (command.type == 3) {
-        puint32 c = 0, arg1, arg2;
-
-        if (attribs == NULL) {
-          command.two_args.command(appState,
-                                   cursor,
-                                   command.two_args.args[0].defaultValue,
-                                   command.two_args.args[1].defaultValue);
-          goto EndCSI;
-        }
+  switch (PostParserGetKey(parser, ch)) {
+    case PostParserKey(0, 0, POST_UNICODE_7): // DECSC
+      PostAppSaveCursor(appState, cursor);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_8): // DECRC
+      PostAppRestoreCursor(appState, cursor);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_D): // IND
+      PostAppIndex(appState, cursor);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_E): // NEL
+      PostAppNextLine(appState, cursor);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_M): // RI
+      PostAppReverseIndex(appState, cursor);
+      break;
+    case PostParserKey(0, 0, POST_UNICODE_BACKSLASH): // ST
+      break;
+    default:
+      PostAppLogWarning(appState, "Unknown Escape Sequence: ESC '%c'", ch);
+      break;
+  }
+}
+
+static inline pbool
+PostParserEndsString(puint8 ch)
+{
+  return ch == POST_UNICODE_BEL || ch == POST_UNICODE_ESC ||
+         ch == POST_UNICODE_CAN || ch == POST_UNICODE_SUB;
+}
+
+static inline pbool
+PostParserIsClipboardHeader(const PostString* osc)
+{
+  return osc->size > 3 && osc->buf[osc->size - 1] == POST_UNICODE_SEMICOLON &&
+         !memcmp(osc->buf, "52;", 3);
+}
+
+static void
+PostParserOSCPut(PostAppState* appState, const puint8* data, pusize len)
+{
+  PostParser* parser = &appState->parser;
+  PostError   error  = POST_ERR_NONE;
+
+  if (parser->stringOverflow)
+    return;
+
+  if (parser->clipboardStream) {
+    PostClipboardPut(appState, &parser->clipboard, data, len);
+    return;
+  }
+
+  // NOTE: the header is taken a byte at a time so OSC 52 is recognized
+  // before its payload reaches the buffer
+  for (; len && parser->osc.size < POST_PARSER_OSC_HEADER_SIZE; ++data, --len) {
+    if ((error = PostStringAppendChar(&parser->osc, data[0])) != POST_ERR_NONE)
+      break;
+
+    if (PostParserIsClipboardHeader(&parser->osc)) {
+      PostClipboardBegin(&parser->clipboard,
+                         (const puint8*) parser->osc.buf + 3,
+                         parser->osc.size - 4);
+      PostClipboardPut(appState, &parser->clipboard, data + 1, len - 1);
+      parser->clipboardStream = 1;
+      return;
+    }
+  }
+
+  if (error == POST_ERR_NONE) {
+    if (parser->osc.size + len > appState->config.maxStringSize) {
+      PostAppLogWarning(appState,
+                        "OSC Exceeds %zu Bytes: Discarding",
+                        (size_t) appState->config.maxStringSize);
+      parser->stringOverflow = 1;
+      return;
+    }
+
+    error = PostStringAppend(&parser->osc, (const char*) data, len);
+  }
+
+  if (error != POST_ERR_NONE) {
+    PostAppLogWarning(appState, "OSC Failed: '%s'", PostErrorString(error));
+    parser->stringOverflow = 1;
+  }
+}
+
+/** splits the next ';' separated field off the front of an OSC payload */
+static const puint8*
+PostParserOSCField(const puint8** data, pusize* len, pusize* fieldLen)
+{
+  const puint8* field = *data;
+  pusize        i;
+
+  for (i = 0; i < *len && field[i] != POST_UNICODE_SEMICOLON; ++i)
+    ;
+
+  *fieldLen = i;
+
+  if (i < *len)
+    ++i;
+
+  *data += i;
+  *len -= i;
+
+  return field;
+}
+
+static pbool
+PostParserOSCNumber(const puint8* field, pusize len, puint32* n)
+{
+  if (!len || len > 5)
+    return 0;
+
+  *n = 0;
+
+  for (pusize i = 0; i < len; ++i) {
+    if (field[i] < POST_UNICODE_0 || field[i] > POST_UNICODE_9)
+      return 0;
+    *n = *n * 10 + (field[i] - POST_UNICODE_0);
+  }
+
+  return 1;
+}
+
+/**
+ * answers a colour query the way xterm does, "OSC command;[index;]rgb:...",
+ * ended with the terminator the query used
+ */
+static void
+PostParserReplyColor(PostAppState* appState,
+                     puint32       command,
+                     const puint8* index,
+                     pusize        indexLen,
+                     PostColor     color,
+                     puint8        terminator)
+{
+  char      buf[32 + POST_PALETTE_COLOR_SPEC_SIZE];
+  int       n;
+  PostError error;
+
+  if (indexLen > 5)
+    return;
+
+  n = snprintf(buf, 32, "\x1b]%u;", command);
+
+  if (indexLen) {
+    memcpy(buf + n, index, indexLen);
+    n += indexLen;
+    buf[n++] = POST_UNICODE_SEMICOLON;
+  }
+
+  n += PostPaletteFormatColor(color, buf + n);
+
+  if (terminator == POST_UNICODE_BEL)
+    buf[n++] = POST_UNICODE_BEL;
+  else {
+    buf[n++] = POST_UNICODE_ESC;
+    buf[n++] = POST_UNICODE_BACKSLASH;
+  }
+
+  error = PostAppReply(appState, buf, n);
+
+  if (error != POST_ERR_NONE)
+    PostAppLogWarning(
+      appState, "OSC %u Failed: '%s'", command, PostErrorString(error));
+}
+
+/** OSC 4 ("index;spec;index;spec...") sets or queries palette entries */
+static void
+PostParserSetPalette(PostAppState* appState,
+                     const puint8* data,
+                     pusize        len,
+                     puint8        terminator)
+{
+  PostPalette* palette = &appState->palette;
+
+  while (len) {
+    const puint8 *index, *spec;
+    pusize        indexLen, specLen;
+    puint32       n;
+
+    index = PostParserOSCField(&data, &len, &indexLen);
+    spec  = PostParserOSCField(&data, &len, &specLen);
+
+    if (!PostParserOSCNumber(index, indexLen, &n) || n >= POST_PALETTE_SIZE) {
+      PostAppLogWarning(appState, "Invalid OSC 4: Bad Color Index");
+      return;
+    }
 
-        PostAttributesIterate(attribs)
-        {
-          if (c++ == 0) {
-            arg1 = current->isEmpty ? command.two_args.args[0].defaultValue
-                                    : current->n;
-          } else {
-            arg2 = current->isEmpty ? command.two_args.args[1].defaultValue
-                                    : current->n;
-            c    = 0;
-            command.two_args.command(appState, cursor, arg1, arg2);
+    if (specLen == 1 && spec[0] == POST_UNICODE_QUESTION_MARK)
+      PostParserReplyColor(
+        appState, 4, index, indexLen, palette->colors[n], terminator);
+    else if (PostPaletteParseColor(spec, specLen, palette->colors + n) !=
+             POST_ERR_NONE)
+      PostAppLogWarning(appState, "Invalid OSC 4: Bad Color Spec");
+  }
+}
+
+/**
+ * OSC 10 and 11 set or query the default foreground and background, extra
+ * specs move on to the next dynamic colour like xterm ("10;fg;bg")
+ */
+static void
+PostParserSetDynamicColors(PostAppState* appState,
+                           puint32       command,
+                           const puint8* data,
+                           pusize        len,
+                           puint8        terminator)
+{
+  PostPalette* palette = &appState->palette;
+
+  for (; len && command <= 11; ++command) {
+    PostColor*    color = command == 10 ? &palette->fg : &palette->bg;
+    pusize        specLen;
+    const puint8* spec = PostParserOSCField(&data, &len, &specLen);
+
+    if (specLen == 1 && spec[0] == POST_UNICODE_QUESTION_MARK)
+      PostParserReplyColor(appState, command, NULL, 0, *color, terminator);
+    else if (PostPaletteParseColor(spec, specLen, color) != POST_ERR_NONE)
+      PostAppLogWarning(appState, "Invalid OSC %u: Bad Color Spec", command);
+  }
+}
+
+/** OSC 104 resets the listed palette entries, or all of them */
+static void
+PostParserResetPalette(PostAppState* appState, const puint8* data, pusize len)
+{
+  PostPalette* palette = &appState->palette;
+
+  if (!len) {
+    PostPaletteInit(palette, palette->fg, palette->bg);
+    return;
+  }
+
+  while (len) {
+    pusize        indexLen;
+    const puint8* index = PostParserOSCField(&data, &len, &indexLen);
+    puint32       n;
+
+    if (PostParserOSCNumber(index, indexLen, &n) && n < POST_PALETTE_SIZE)
+      palette->colors[n] = PostPaletteDefaultColor(n);
+  }
+}
+
+static void
+PostParserDispatchOSC(PostAppState* appState,
+                      const puint8* data,
+                      pusize        len,
+                      puint8        terminator)
+{
+  PostParser*   parser = &appState->parser;
+  puint32       command = 0;
+  const puint8* selection;
+  pusize        i;
+
+  for (i = 0; i < len && data[i] >= POST_UNICODE_0 && data[i] <= POST_UNICODE_9;
+       ++i)
+    if ((command = command * 10 + (data[i] - POST_UNICODE_0)) > 0xFFFF)
+      break;
+
+  if (!i || (i < len && data[i] != POST_UNICODE_SEMICOLON)) {
+    PostAppLogWarning(appState, "Invalid OSC: Expected 'Ps;Pt'");
+    return;
+  }
+
+  // NOTE: Pt may be left out entirely, OSC 104 resets the whole palette
+  if (i < len)
+    ++i;
+
+  data += i;
+  len -= i;
+
+  switch (command) {
+    case 0:
+    case 1:
+    case 2:
+      PostAppSetTitle(appState, (const char*) data, len);
+      break;
+    case 4:
+      PostParserSetPalette(appState, data, len, terminator);
+      break;
+    case 10:
+    case 11:
+      PostParserSetDynamicColors(appState, command, data, len, terminator);
+      break;
+    case 52:
+      selection = data;
+
+      for (i = 0; i < len && data[i] != POST_UNICODE_SEMICOLON; ++i)
+        ;
+
+      if (i == len) {
+        PostAppLogWarning(appState, "Invalid OSC 52: Expected 'Pc;Pd'");
+        break;
+      }
+
+      PostClipboardBegin(&parser->clipboard, selection, i);
+      PostClipboardPut(
+        appState, &parser->clipboard, data + i + 1, len - (i + 1));
+      PostClipboardEnd(appState, &parser->clipboard, terminator);
+      break;
+    case 104:
+      PostParserResetPalette(appState, data, len);
+      break;
+    case 110:
+      appState->palette.fg = appState->config.fg;
+      break;
+    case 111:
+      appState->palette.bg = appState->config.bg;
+      break;
+    default:
+      PostAppLogWarning(appState, "Unknown OSC Command: %u", command);
+      break;
+  }
+}
+
+static void
+PostParserOSCEnd(PostAppState* appState, puint8 ch)
+{
+  PostParser* parser = &appState->parser;
+
+  // NOTE: CAN and SUB abort the string instead of terminating it
+  if (ch == POST_UNICODE_CAN || ch == POST_UNICODE_SUB ||
+      parser->stringOverflow)
+    ;
+  else if (parser->clipboardStream)
+    PostClipboardEnd(appState, &parser->clipboard, ch);
+  else if (parser->oscSpan != NULL)
+    PostParserDispatchOSC(appState, parser->oscSpan, parser->oscSpanLen, ch);
+  else
+    PostParserDispatchOSC(
+      appState, (const puint8*) parser->osc.buf, parser->osc.size, ch);
+
+  parser->oscSpan         = NULL;
+  parser->clipboardStream = 0;
+}
+
+static inline void
+PostParserAction(PostAppState* appState,
+                 PostCursor*   cursor,
+                 puint8        action,
+                 puint8        ch)
+{
+  PostParser* parser = &appState->parser;
+
+  switch (action) {
+    case POST_VT_ACTION_NONE:
+    case POST_VT_ACTION_IGNORE:
+      break;
+    case POST_VT_ACTION_PRINT:
+      PostAppWriteASCII(appState, cursor, &ch, 1);
+      PostGraphemeBreakerReset(&parser->grapheme, POST_GRAPHEME_OTHER);
+      parser->lastCodepoint = ch;
+      break;
+    case POST_VT_ACTION_EXECUTE:
+      PostAppExecute(appState, cursor, ch);
+      break;
+    case POST_VT_ACTION_CLEAR:
+      PostParserClear(parser);
+      break;
+    case POST_VT_ACTION_COLLECT:
+      PostParserCollect(parser, ch);
+      break;
+    case POST_VT_ACTION_PARAM:
+      PostParserParam(parser, ch);
+      break;
+    case POST_VT_ACTION_ESC_DISPATCH:
+      PostParserDispatchESC(appState, cursor, ch);
+      break;
+    case POST_VT_ACTION_CSI_DISPATCH:
+      PostParserDispatchCSI(appState, cursor, ch);
+      break;
+    case POST_VT_ACTION_HOOK:
+      // NOTE: device control strings are consumed and not dispatched, so
+      // the payload never reaches the screen
+      PostAppLogWarning(appState, "Unsupported DCS: '%c'", ch);
+      break;
+    case POST_VT_ACTION_PUT:
+    case POST_VT_ACTION_UNHOOK:
+      break;
+    case POST_VT_ACTION_OSC_START:
+      parser->osc.size        = 0;
+      parser->oscSpan         = NULL;
+      parser->stringOverflow  = 0;
+      parser->clipboardStream = 0;
+      break;
+    case POST_VT_ACTION_OSC_PUT:
+      PostParserOSCPut(appState, &ch, 1);
+      break;
+    case POST_VT_ACTION_OSC_END:
+      PostParserOSCEnd(appState, ch);
+      break;
+  }
+}
+
+/**
+ * splits codepoints at grapheme cluster boundaries, a zero width codepoint
+ * that continues a cluster is attached to the cell holding it
+ */
+static void
+PostParserWriteCodepoints(PostAppState*  appState,
+                          PostCursor*    cursor,
+                          const puint32* codepoints,
+                          pusize         len)
+{
+  PostParser*          parser  = &appState->parser;
+  PostGraphemeBreaker* breaker = &parser->grapheme;
+  pusize               start   = 0;
+
+  for (pusize i = 0; i < len; ++i) {
+    // NOTE: a continuation with a width of its own still gets its own cells
+    // so the cursor agrees with wcwidth(3) in the child
+    if (PostGraphemeBreak(breaker, codepoints[i]) ||
+        PostCodepointWidth(codepoints[i]))
+      continue;
+
+    if (i > start)
+      parser->lastCodepoint = codepoints[i - 1];
+
+    PostAppWriteCodepoints(appState, cursor, codepoints + start, i - start);
+    PostAppExtendCluster(appState, cursor, codepoints[i]);
+    start = i + 1;
+  }
+
+  if (len > start)
+    parser->lastCodepoint = codepoints[len - 1];
+
+  PostAppWriteCodepoints(appState, cursor, codepoints + start, len - start);
+}
+
+/**
+ * decodes and writes the non-ASCII run at the start of str, returns the
+ * number of bytes consumed which may be 0 when an ASCII byte only terminated
+ * a pending sequence
+ */
+static pusize
+PostParserWriteUTF8(PostAppState* appState,
+                    PostCursor*   cursor,
+                    const puint8* str,
+                    pusize        len)
+{
+  puint32 codepoints[64];
+  pusize  consumed = 0, numCodepoints;
+
+  do {
+    pusize n = PostUTF8Decode(&appState->parser.utf8,
+                              str + consumed,
+                              len - consumed,
+                              codepoints,
+                              sizeof(codepoints) / sizeof(*codepoints),
+                              &numCodepoints);
+
+    PostParserWriteCodepoints(appState, cursor, codepoints, numCodepoints);
+
+    consumed += n;
+  } while (numCodepoints && consumed < len);
+
+  return consumed;
+}
+
+void
+PostParserInit(PostParser* parser)
+{
+  *parser = (PostParser) { .state = POST_VT_STATE_GROUND };
+  PostUTF8DecoderReset(&parser->utf8);
+  PostGraphemeBreakerReset(&parser->grapheme, POST_GRAPHEME_CONTROL);
+}
+
+void
+PostParserFini(PostParser* parser)
+{
+  PostStringRelease(&parser->osc);
+  PostClipboardRelease(&parser->clipboard);
+}
+
+pusize
+PostParse(PostAppState* appState, const puint8* data, pusize len)
+{
+  PostParser*   parser = &appState->parser;
+  PostCursor    cursor = appState->cursor;
+  const puint8* str    = data;
+  const puint8* end    = data + len;
+
+  while (str != end) {
+    puint8 ch = str[0], transition, next;
+
+    // NOTE: the common paths through GROUND and CSI skip the table, the
+    // result is identical to taking the transitions one byte at a time
+    switch (parser->state) {
+      case POST_VT_STATE_GROUND:
+        if (ch >= 0x80 || !PostUTF8DecoderIsIdle(&parser->utf8)) {
+          pusize n = PostParserWriteUTF8(appState, &cursor, str, end - str);
+
+          if (n) {
+            str += n;
+            continue;
           }
+
+          // NOTE: the pending sequence was cut short, the byte is handled
+          // below
+        } else if (ch >= POST_UNICODE_SPACE && ch <= POST_UNICODE_TILDE) {
+          pusize run = PostScanPrintableASCII(str, end - str);
+          PostAppWriteASCII(appState, &cursor, str, run);
+          PostGraphemeBreakerReset(&parser->grapheme, POST_GRAPHEME_OTHER);
+          parser->lastCodepoint = str[run - 1];
+          str += run;
+          continue;
+        } else if (ch == POST_UNICODE_ESC && end - str > 1 &&
+                   str[1] == POST_UNICODE_LBRACK) {
+          PostParserClear(parser);
+          parser->state = POST_VT_STATE_CSI_ENTRY;
+          str += 2;
+          continue;
+        }
+        break;
+      case POST_VT_STATE_CSI_ENTRY:
+      case POST_VT_STATE_CSI_PARAM:
+        if (ch >= POST_UNICODE_0 && ch <= POST_UNICODE_SEMICOLON) {
+          do
+            PostParserParam(parser, *str);
+          while (++str != end && *str >= POST_UNICODE_0 &&
+                 *str <= POST_UNICODE_SEMICOLON);
+
+          parser->state = POST_VT_STATE_CSI_PARAM;
+          continue;
         }
 
-        if (c)
-          command.two_args.command(
-            appState, cursor, arg1, command.two_args.args[1].defaultValue);
-      } else {
-        PostAppLogWarning(appState, "Internal Error: Invalid Command Type");
-        PostAttributesIterate(attribs);
+        if (ch >= POST_UNICODE_AT_SIGN && ch <= POST_UNICODE_TILDE) {
+          PostGraphemeBreakerReset(&parser->grapheme, POST_GRAPHEME_CONTROL);
+          PostParserDispatchCSI(appState, &cursor, ch);
+          parser->state = POST_VT_STATE_GROUND;
+          ++str;
+          continue;
+        }
+        break;
+      case POST_VT_STATE_OSC_STRING: {
+        pusize run = PostScanStringPayload(str, end - str);
+
+        if (!run)
+          break;
+
+        // NOTE: a payload that starts and ends in this chunk is used in place,
+        // anything else is copied into the bounded buffer
+        if (!parser->osc.size && !parser->stringOverflow &&
+            !parser->clipboardStream &&
+            run <= appState->config.maxStringSize &&
+            (pusize) (end - str) > run && PostParserEndsString(str[run])) {
+          parser->oscSpan    = str;
+          parser->oscSpanLen = run;
+        } else
+          PostParserOSCPut(appState, str, run);
+
+        str += run;
+        continue;
+      }
+      case POST_VT_STATE_DCS_PASSTHROUGH:
+      case POST_VT_STATE_DCS_IGNORE:
+      case POST_VT_STATE_SOS_PM_APC_STRING: {
+        // NOTE: no DCS is supported yet so every payload is skipped in bulk
+        pusize run = PostScanStringPayload(str, end - str);
+
+        if (!run)
+          break;
+
+        str += run;
+        continue;
       }
+    }
 
-      goto EndCSI;
+    PostGraphemeBreakerReset(&parser->grapheme, POST_GRAPHEME_CONTROL);
+
+    transition = postVTTransitions[parser->state][ch];
+    next       = PostVTNextState(transition);
+
+    if (next == POST_VT_STAY)
+      PostParserAction(appState, &cursor, PostVTAction(transition), ch);
+    else {
+      if (postVTExitActions[parser->state] != POST_VT_ACTION_NONE)
+        PostParserAction(
+          appState, &cursor, postVTExitActions[parser->state], ch);
+      PostParserAction(appState, &cursor, PostVTAction(transition), ch);
+      if (postVTEntryActions[next] != POST_VT_ACTION_NONE)
+        PostParserAction(appState, &cursor, postVTEntryActions[next], ch);
+      parser->state = next;
     }
+
+    ++str;
   }
 
-  PostAppLogWarning(
-    appState, "Unknown Command Sequence Introducer: ESC[%c", (unsigned) ch, ch);
+  appState->cursor = cursor;
 
-EndCSI:
-  appState->parser.state         = POST_PARSER_STATE_NORMAL;
-  appState->parser.currentAttrib = NULL;
-  appState->parser.attribs       = NULL;
+  return str - data;
 }
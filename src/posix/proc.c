@@ -20,6 +20,8 @@
  * IN THE SOFTWARE.
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <poll.h>
 #include <pty.h>
 #include <stdio.h>
@@ -69,6 +71,16 @@ PostChildProcessSpawn(char* executable, FILE** master, PostProc** childProcess)
 
     close(aslave);
 
+#ifdef POST_TERMINFO_DIR
+    // NOTE: the child only gets TERM=post once the entry is installed,
+    // otherwise it keeps the TERM it inherited
+    if (!access(POST_TERMINFO_DIR "/p/post", R_OK) ||
+        !access(POST_TERMINFO_DIR "/70/post", R_OK)) {
+      setenv("TERMINFO", POST_TERMINFO_DIR, 1);
+      setenv("TERM", "post", 1);
+    }
+#endif
+
     char* argv[] = { executable, NULL };
     execve(executable, argv, environ);
   }
@@ -100,7 +112,7 @@ PostChildProcessPoll(PostAppState* appState)
   int fd = fileno(appState->master);
   int result;
 
-  char    buf[256];
+  puint8  buf[4096];
   ssize_t bytes;
 
   struct pollfd fds = {
@@ -113,11 +125,10 @@ PollChild:
 
   if (result == 1) {
     if (fds.revents & POLLIN) {
-      bytes = read(fd, buf, 255);
+      bytes = read(fd, buf, sizeof(buf));
       if (bytes > 0) {
-        buf[bytes] = 0x0;
-        PostAppWriteASCIIString(appState, buf);
-        if (bytes == 255)
+        PostAppWriteBytes(appState, buf, bytes);
+        if ((pusize) bytes == sizeof(buf))
           goto PollChild;
       }
     }
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "post/tempfile.h"
+
+struct PostTempFile
+{
+  int     fd;
+  puint64 size;
+};
+
+PostError
+PostTempFileCreate(PostTempFile** file)
+{
+  PostTempFile* _file = malloc(sizeof(PostTempFile));
+  const char*   dir   = getenv("TMPDIR");
+  char          path[4096];
+
+  if (_file == NULL)
+    return POST_ERR_OUT_OF_MEMORY;
+
+  if (dir == NULL || *dir == '\0')
+    dir = "/tmp";
+
+  if (snprintf(path, sizeof(path), "%s/post-XXXXXX", dir) >=
+      (int) sizeof(path)) {
+    free(_file);
+    return POST_ERR_BAD_ARG;
+  }
+
+  if ((_file->fd = mkstemp(path)) == -1) {
+    free(_file);
+    return POST_ERR_POSIX;
+  }
+
+  unlink(path);
+
+  _file->size = 0;
+  *file       = _file;
+
+  return POST_ERR_NONE;
+}
+
+void
+PostTempFileDestroy(PostTempFile* file)
+{
+  close(file->fd);
+  free(file);
+}
+
+PostError
+PostTempFileAppend(PostTempFile* file,
+                   const void*   data,
+                   pusize        size,
+                   puint64*      offset)
+{
+  const puint8* bytes = data;
+  puint64       end   = file->size;
+
+  while (size) {
+    ssize_t n = pwrite(file->fd, bytes, size, end);
+
+    if (n == -1) {
+      if (errno == EINTR)
+        continue;
+
+      // NOTE: whatever made it out before the error is simply overwritten by
+      // the next append
+      return POST_ERR_POSIX;
+    }
+
+    bytes += n;
+    size -= n;
+    end += n;
+  }
+
+  *offset    = file->size;
+  file->size = end;
+
+  return POST_ERR_NONE;
+}
+
+PostError
+PostTempFileMap(PostTempFile*     file,
+                puint64           offset,
+                pusize            size,
+                PostTempFileView* view)
+{
+  // NOTE: mmap wants an offset that is a multiple of the page size
+  puint64 start = offset - offset % sysconf(_SC_PAGESIZE);
+
+  if (offset + size > file->size)
+    return POST_ERR_BAD_ARG;
+
+  view->length = offset - start + size;
+  view->base =
+    mmap(NULL, view->length, PROT_READ, MAP_SHARED, file->fd, (off_t) start);
+
+  if (view->base == MAP_FAILED) {
+    view->base = NULL;
+    return POST_ERR_POSIX;
+  }
+
+  view->data = (const puint8*) view->base + (offset - start);
+
+  return POST_ERR_NONE;
+}
+
+void
+PostTempFileUnmap(PostTempFileView* view)
+{
+  if (view->base != NULL)
+    munmap(view->base, view->length);
+
+  view->base = NULL;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "post/thread.h"
+
+struct PostThread
+{
+  pthread_t      handle;
+  PostThreadFunc func;
+  void*          arg;
+};
+
+struct PostEvent
+{
+  sem_t sem;
+};
+
+static void*
+PostThreadStart(void* arg)
+{
+  PostThread* thread = arg;
+  thread->func(thread->arg);
+  return NULL;
+}
+
+PostError
+PostThreadCreate(PostThread** thread, PostThreadFunc func, void* arg)
+{
+  PostThread* _thread = malloc(sizeof(PostThread));
+
+  if (_thread == NULL)
+    return POST_ERR_OUT_OF_MEMORY;
+
+  _thread->func = func;
+  _thread->arg  = arg;
+
+  if (pthread_create(&_thread->handle, NULL, PostThreadStart, _thread)) {
+    free(_thread);
+    return POST_ERR_POSIX;
+  }
+
+  *thread = _thread;
+
+  return POST_ERR_NONE;
+}
+
+void
+PostThreadJoin(PostThread* thread)
+{
+  pthread_join(thread->handle, NULL);
+  free(thread);
+}
+
+PostError
+PostEventCreate(PostEvent** event)
+{
+  PostEvent* _event = malloc(sizeof(PostEvent));
+
+  if (_event == NULL)
+    return POST_ERR_OUT_OF_MEMORY;
+
+  if (sem_init(&_event->sem, 0, 0)) {
+    free(_event);
+    return POST_ERR_POSIX;
+  }
+
+  *event = _event;
+
+  return POST_ERR_NONE;
+}
+
+void
+PostEventDestroy(PostEvent* event)
+{
+  sem_destroy(&event->sem);
+  free(event);
+}
+
+void
+PostEventSignal(PostEvent* event)
+{
+  sem_post(&event->sem);
+}
+
+void
+PostEventWait(PostEvent* event)
+{
+  while (sem_wait(&event->sem) && errno == EINTR)
+    ;
+}
+
+puint64
+PostTimeNanos(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (puint64) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
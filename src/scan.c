@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "post/scan.h"
+#include "post/unicode.h"
+
+static inline pbool
+PostIsPrintableASCII(puint8 ch)
+{
+  return ch >= POST_UNICODE_SPACE && ch <= POST_UNICODE_TILDE;
+}
+
+static inline pbool
+PostIsStringPayload(puint8 ch)
+{
+  return ch >= POST_UNICODE_SPACE && ch != POST_UNICODE_DEL;
+}
+
+pusize
+PostScanPrintableASCII(const puint8* data, pusize len)
+{
+  pusize i = 0;
+
+#if defined(__AVX2__)
+  const __m256i lo = _mm256_set1_epi8(0x1F);
+  const __m256i hi = _mm256_set1_epi8(0x7F);
+
+  for (; i + 32 <= len; i += 32) {
+    // NOTE: bytes >= 0x80 are negative as signed chars and fail the first test
+    __m256i v    = _mm256_loadu_si256((const __m256i*) (data + i));
+    __m256i ok   = _mm256_and_si256(_mm256_cmpgt_epi8(v, lo),
+                                  _mm256_cmpgt_epi8(hi, v));
+    puint32 mask = ~(puint32) _mm256_movemask_epi8(ok);
+
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+#endif
+
+#if defined(__SSE2__)
+  const __m128i lo128 = _mm_set1_epi8(0x1F);
+  const __m128i hi128 = _mm_set1_epi8(0x7F);
+
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*) (data + i));
+    __m128i ok =
+      _mm_and_si128(_mm_cmpgt_epi8(v, lo128), _mm_cmplt_epi8(v, hi128));
+    puint32 mask = ~(puint32) _mm_movemask_epi8(ok) & 0xFFFF;
+
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+#endif
+
+  for (; i < len; ++i)
+    if (!PostIsPrintableASCII(data[i]))
+      break;
+
+  return i;
+}
+
+pusize
+PostScanStringPayload(const puint8* data, pusize len)
+{
+  pusize i = 0;
+
+#if defined(__AVX2__)
+  const __m256i space = _mm256_set1_epi8(0x20);
+  const __m256i del   = _mm256_set1_epi8(0x7F);
+
+  for (; i + 32 <= len; i += 32) {
+    // NOTE: max(v, 0x20) == v is an unsigned v >= 0x20
+    __m256i v    = _mm256_loadu_si256((const __m256i*) (data + i));
+    __m256i ok   = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, del),
+                                     _mm256_cmpeq_epi8(
+                                       _mm256_max_epu8(v, space), v));
+    puint32 mask = ~(puint32) _mm256_movemask_epi8(ok);
+
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+#endif
+
+#if defined(__SSE2__)
+  const __m128i space128 = _mm_set1_epi8(0x20);
+  const __m128i del128   = _mm_set1_epi8(0x7F);
+
+  for (; i + 16 <= len; i += 16) {
+    __m128i v  = _mm_loadu_si128((const __m128i*) (data + i));
+    __m128i ok = _mm_andnot_si128(
+      _mm_cmpeq_epi8(v, del128),
+      _mm_cmpeq_epi8(_mm_max_epu8(v, space128), v));
+    puint32 mask = ~(puint32) _mm_movemask_epi8(ok) & 0xFFFF;
+
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+#endif
+
+  for (; i < len; ++i)
+    if (!PostIsStringPayload(data[i]))
+      break;
+
+  return i;
+}
@@ -0,0 +1,1236 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "post/app.h"
+#include "post/scrollback.h"
+
+#define POST_SCROLLBACK_QUEUE_MASK (POST_SCROLLBACK_QUEUE_SIZE - 1)
+
+/** the longest line a page can hold, longer lines are cut short */
+#define POST_SCROLLBACK_PAGE_CELLS                                             \
+  ((POST_SCROLLBACK_PAGE_SIZE - sizeof(PostScrollbackPage) -                   \
+    sizeof(puint16)) /                                                         \
+   sizeof(PostCell))
+
+/**
+ * most bytes a page can pack to, a 5 byte codepoint and a style and flag run
+ * of 3 + 2 bytes each per cell, 2 bytes per line length
+ */
+#define POST_SCROLLBACK_PACK_BOUND                                             \
+  (POST_SCROLLBACK_PAGE_CELLS * 15 + POST_SCROLLBACK_PAGE_CELLS * 2)
+
+// NOTE: a page has at most POST_SCROLLBACK_PAGE_CELLS distinct styles and
+// as many distinct clusters so the map is never more than half full
+#define POST_SCROLLBACK_MAP_BITS 15
+#define POST_SCROLLBACK_MAP_SIZE (1 << POST_SCROLLBACK_MAP_BITS)
+#define POST_SCROLLBACK_MAP_MASK (POST_SCROLLBACK_MAP_SIZE - 1)
+
+/**
+ * a page in the spill file, the packed page with ids of its own in place of
+ * style ids and clusters, followed by what those ids stand for, numStyles
+ * PostStyles for ids 1 onwards (0 is the default style) and then numClusters
+ * clusters as their length followed by their codepoints
+ */
+typedef struct
+{
+  puint32 numCells;
+  puint32 numStyles;
+  puint32 numClusters;
+  puint32 packedSize;
+} PostScrollbackRecord;
+
+struct PostScrollbackSpiller
+{
+  /** a raw page is packed here before its ids are rewritten */
+  puint8* scratch;
+  puint8* record;
+  pusize  maxRecord;
+  /** table id (or tagged cluster) of each of the page's own ids */
+  puint16 styles[POST_SCROLLBACK_PAGE_CELLS + 1];
+  puint32 clusters[POST_SCROLLBACK_PAGE_CELLS];
+  puint32 numStyles, numClusters;
+  /**
+   * open addressing from table ids to the page's ids, a slot whose stamp is
+   * not the current one is empty so the map is cleared by bumping stamp
+   */
+  puint32 keys[POST_SCROLLBACK_MAP_SIZE];
+  puint32 values[POST_SCROLLBACK_MAP_SIZE];
+  puint32 stamps[POST_SCROLLBACK_MAP_SIZE];
+  puint32 stamp;
+};
+
+/**
+ * set in the offset of a line that continues on the next one, offsets are
+ * below POST_SCROLLBACK_PAGE_CELLS so the top bit is free
+ */
+#define POST_SCROLLBACK_WRAPPED 0x8000
+
+/** where the offset of line i is kept, counting back from the page's end */
+static inline puint16*
+PostScrollbackOffset(const PostScrollbackPage* page, puint32 i)
+{
+  return (puint16*) ((puint8*) page + POST_SCROLLBACK_PAGE_SIZE) - 1 - i;
+}
+
+static inline puint32
+PostScrollbackLineStart(const PostScrollbackPage* page, puint32 i)
+{
+  return *PostScrollbackOffset(page, i) & ~POST_SCROLLBACK_WRAPPED;
+}
+
+static inline puint32
+PostScrollbackLineEnd(const PostScrollbackPage* page, puint32 i)
+{
+  return i + 1 < page->numLines ? PostScrollbackLineStart(page, i + 1)
+                                : page->numCells;
+}
+
+static inline pbool
+PostScrollbackLineWrapped(const PostScrollbackPage* page, puint32 i)
+{
+  return (*PostScrollbackOffset(page, i) & POST_SCROLLBACK_WRAPPED) != 0;
+}
+
+static inline pbool
+PostScrollbackFits(const PostScrollbackPage* page, puint32 len)
+{
+  return sizeof(*page) + (page->numCells + len) * sizeof(PostCell) +
+           (page->numLines + 1) * sizeof(puint16) <=
+         POST_SCROLLBACK_PAGE_SIZE;
+}
+
+static inline PostScrollbackSlot*
+PostScrollbackSlotAt(const PostScrollback* scrollback, puint32 i)
+{
+  i += scrollback->firstPage;
+
+  if (i >= scrollback->maxPages)
+    i -= scrollback->maxPages;
+
+  return scrollback->slots + i;
+}
+
+static inline puint64
+PostScrollbackSlotFirstLine(const PostScrollbackSlot* slot)
+{
+  return slot->page != NULL ? slot->page->firstLine : slot->packed->firstLine;
+}
+
+static inline puint32
+PostScrollbackSlotLines(const PostScrollbackSlot* slot)
+{
+  return slot->page != NULL ? slot->page->numLines : slot->packed->numLines;
+}
+
+/** the slot holding line, pages are in line order so this is a bisection */
+static PostScrollbackSlot*
+PostScrollbackFindSlot(const PostScrollback* scrollback, puint64 line)
+{
+  puint32 lo = 0, hi = scrollback->numPages - 1;
+
+  while (lo < hi) {
+    puint32 mid = lo + (hi - lo + 1) / 2;
+
+    if (PostScrollbackSlotFirstLine(PostScrollbackSlotAt(scrollback, mid)) <=
+        line)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+
+  return PostScrollbackSlotAt(scrollback, lo);
+}
+
+static puint8*
+PostScrollbackPutVarint(puint8* out, puint32 value)
+{
+  for (; value >= 0x80; value >>= 7)
+    *out++ = (value & 0x7F) | 0x80;
+
+  *out++ = value;
+
+  return out;
+}
+
+static const puint8*
+PostScrollbackGetVarint(const puint8* in, puint32* value)
+{
+  puint32 shift = 0;
+
+  *value = 0;
+
+  for (; *in & 0x80; shift += 7)
+    *value |= (puint32) (*in++ & 0x7F) << shift;
+
+  *value |= (puint32) *in++ << shift;
+
+  return in;
+}
+
+/** writes the runs of equal styles (or flags) of n cells as value, count */
+static puint8*
+PostScrollbackPutRuns(puint8*         out,
+                      const PostCell* cells,
+                      puint32         n,
+                      pbool           flags)
+{
+  for (puint32 i = 0, j; i < n; i = j) {
+    puint16 value = flags ? cells[i].flags : cells[i].style;
+
+    for (j = i + 1; j < n && (flags ? cells[j].flags : cells[j].style) == value;
+         ++j)
+      ;
+
+    out = PostScrollbackPutVarint(out, value);
+    out = PostScrollbackPutVarint(out, j - i);
+  }
+
+  return out;
+}
+
+/**
+ * writes the packed form of a page to out, log output is mostly ASCII in a
+ * handful of styles so codepoints shrink to a byte and the runs to almost
+ * nothing, out holds POST_SCROLLBACK_PACK_BOUND bytes, returns its new end
+ */
+static puint8*
+PostScrollbackEncode(const PostScrollbackPage* page, puint8* out)
+{
+  // NOTE: the low bit of a line's length is its wrapped flag
+  for (puint32 i = 0; i < page->numLines; ++i)
+    out = PostScrollbackPutVarint(
+      out,
+      (PostScrollbackLineEnd(page, i) - PostScrollbackLineStart(page, i)) << 1 |
+        PostScrollbackLineWrapped(page, i));
+
+  out = PostScrollbackPutRuns(out, page->cells, page->numCells, 0);
+  out = PostScrollbackPutRuns(out, page->cells, page->numCells, 1);
+
+  for (puint32 i = 0; i < page->numCells; ++i)
+    out = PostScrollbackPutVarint(out, page->cells[i].charCode);
+
+  return out;
+}
+
+/**
+ * compresses a page, returns NULL when the page would not get smaller,
+ * scratch holds the bound
+ */
+static PostScrollbackPacked*
+PostScrollbackPack(const PostScrollbackPage* page, puint8* scratch)
+{
+  PostScrollbackPacked* packed;
+  pusize                size = PostScrollbackEncode(page, scratch) - scratch;
+
+  if (size >= page->numCells * sizeof(PostCell))
+    return NULL;
+
+  packed = malloc(sizeof(*packed) + size);
+  if (packed == NULL)
+    return NULL;
+
+  packed->firstLine = page->firstLine;
+  packed->numLines  = page->numLines;
+  packed->numCells  = page->numCells;
+  packed->size      = size;
+  memcpy(packed->data, scratch, size);
+
+  return packed;
+}
+
+/**
+ * fills page from packed data, styles and clusters map the ids of a spilled
+ * page back to table ids and are NULL for pages that never left the ring
+ */
+static void
+PostScrollbackUnpack(const puint8*       in,
+                     puint64             firstLine,
+                     puint32             numLines,
+                     puint32             numCells,
+                     const puint16*      styles,
+                     const puint32*      clusters,
+                     PostScrollbackPage* page)
+{
+  puint32 offset = 0, value, count;
+
+  page->firstLine = firstLine;
+  page->numLines  = numLines;
+  page->numCells  = numCells;
+  page->queued    = 0;
+  page->evicted   = 0;
+
+  for (puint32 i = 0; i < numLines; ++i) {
+    in = PostScrollbackGetVarint(in, &value);
+
+    *PostScrollbackOffset(page, i) =
+      offset | (value & 1 ? POST_SCROLLBACK_WRAPPED : 0);
+    offset += value >> 1;
+  }
+
+  for (puint32 i = 0; i < numCells;) {
+    in = PostScrollbackGetVarint(in, &value);
+    in = PostScrollbackGetVarint(in, &count);
+
+    if (styles != NULL)
+      value = styles[value];
+
+    for (; count; --count)
+      page->cells[i++].style = value;
+  }
+
+  for (puint32 i = 0; i < numCells;) {
+    in = PostScrollbackGetVarint(in, &value);
+    in = PostScrollbackGetVarint(in, &count);
+
+    for (; count; --count)
+      page->cells[i++].flags = value;
+  }
+
+  for (puint32 i = 0; i < numCells; ++i) {
+    in = PostScrollbackGetVarint(in, &value);
+
+    if (clusters != NULL && PostIsCluster(value))
+      value = clusters[value & ~POST_CLUSTER_TAG];
+
+    page->cells[i].charCode = value;
+  }
+}
+
+/** drops the references of a compressed page without unpacking it */
+static void
+PostScrollbackReleasePacked(PostAppState*               appState,
+                            const PostScrollbackPacked* packed)
+{
+  const puint8* in = packed->data;
+  puint32       value, count;
+
+  if (!appState->styles.numLive && !appState->clusters.numLive)
+    return;
+
+  for (puint32 i = 0; i < packed->numLines; ++i)
+    in = PostScrollbackGetVarint(in, &value);
+
+  for (puint32 i = 0; i < packed->numCells; i += count) {
+    in = PostScrollbackGetVarint(in, &value);
+    in = PostScrollbackGetVarint(in, &count);
+    PostStyleRelease(&appState->styles, value, count);
+  }
+
+  for (puint32 i = 0; i < packed->numCells; i += count) {
+    in = PostScrollbackGetVarint(in, &value);
+    in = PostScrollbackGetVarint(in, &count);
+  }
+
+  if (appState->clusters.numLive)
+    for (puint32 i = 0; i < packed->numCells; ++i) {
+      in = PostScrollbackGetVarint(in, &value);
+      PostClusterRelease(&appState->clusters, value);
+    }
+}
+
+static void
+PostScrollbackThread(void* arg)
+{
+  PostScrollback* scrollback = arg;
+  puint8*         scratch    = malloc(POST_SCROLLBACK_PACK_BOUND);
+
+  while (atomic_load_explicit(&scrollback->running, memory_order_acquire)) {
+    PostEventWait(scrollback->wake);
+
+    while (scrollback->jobTail != atomic_load_explicit(&scrollback->jobHead,
+                                                       memory_order_acquire)) {
+      PostScrollbackPage* page =
+        scrollback->jobs[scrollback->jobTail & POST_SCROLLBACK_QUEUE_MASK];
+      puint32 head = atomic_load_explicit(&scrollback->resultHead,
+                                          memory_order_relaxed);
+
+      // NOTE: without a scratch buffer every page comes back as it was
+      scrollback->results[head & POST_SCROLLBACK_QUEUE_MASK] =
+        (PostScrollbackResult) {
+          .page   = page,
+          .packed = scratch != NULL ? PostScrollbackPack(page, scratch) : NULL,
+        };
+
+      atomic_store_explicit(
+        &scrollback->resultHead, head + 1, memory_order_release);
+      ++scrollback->jobTail;
+    }
+  }
+
+  free(scratch);
+}
+
+static PostError
+PostScrollbackStart(PostScrollback* scrollback)
+{
+  PostError error;
+
+  PostTry(PostEventCreate(&scrollback->wake));
+
+  atomic_store_explicit(&scrollback->running, 1, memory_order_release);
+
+  error =
+    PostThreadCreate(&scrollback->thread, PostScrollbackThread, scrollback);
+
+  if (error != POST_ERR_NONE) {
+    atomic_store_explicit(&scrollback->running, 0, memory_order_release);
+    PostEventDestroy(scrollback->wake);
+    scrollback->thread = NULL;
+    scrollback->wake   = NULL;
+  }
+
+  return error;
+}
+
+/** keeps an emptied page for the next push, there is only room for one */
+static void
+PostScrollbackRecycle(PostScrollback* scrollback, PostScrollbackPage* page)
+{
+  if (scrollback->spare == NULL)
+    scrollback->spare = page;
+  else
+    free(page);
+}
+
+/** takes back the pages the compression thread is done with */
+static void
+PostScrollbackCollect(PostScrollback* scrollback)
+{
+  puint32 head =
+    atomic_load_explicit(&scrollback->resultHead, memory_order_acquire);
+
+  for (; scrollback->resultTail != head; ++scrollback->resultTail) {
+    PostScrollbackResult* result =
+      &scrollback->results[scrollback->resultTail & POST_SCROLLBACK_QUEUE_MASK];
+    PostScrollbackPage* page = result->page;
+    PostScrollbackSlot* slot;
+
+    --scrollback->numQueued;
+    page->queued = 0;
+
+    if (page->evicted) {
+      free(result->packed);
+      free(page);
+      continue;
+    }
+
+    if (result->packed == NULL)
+      continue;
+
+    slot         = PostScrollbackFindSlot(scrollback, page->firstLine);
+    slot->packed = result->packed;
+    slot->page   = NULL;
+
+    PostScrollbackRecycle(scrollback, page);
+  }
+}
+
+/** hands the page that just stopped being hot to the compression thread */
+static void
+PostScrollbackQueue(PostScrollback* scrollback)
+{
+  PostScrollbackPage* page;
+  puint32             head;
+
+  if (scrollback->numPages <= POST_SCROLLBACK_HOT_PAGES ||
+      scrollback->numQueued == POST_SCROLLBACK_QUEUE_SIZE)
+    return;
+
+  page = PostScrollbackSlotAt(scrollback,
+                              scrollback->numPages - 1 -
+                                POST_SCROLLBACK_HOT_PAGES)
+           ->page;
+
+  if (page == NULL || page->queued)
+    return;
+
+  // NOTE: without the thread pages simply stay uncompressed
+  if (scrollback->thread == NULL &&
+      PostScrollbackStart(scrollback) != POST_ERR_NONE)
+    return;
+
+  head = atomic_load_explicit(&scrollback->jobHead, memory_order_relaxed);
+
+  scrollback->jobs[head & POST_SCROLLBACK_QUEUE_MASK] = page;
+  page->queued                                        = 1;
+  ++scrollback->numQueued;
+
+  atomic_store_explicit(&scrollback->jobHead, head + 1, memory_order_release);
+  PostEventSignal(scrollback->wake);
+}
+
+/** the cache entry holding the page that starts at firstLine, or the size */
+static puint32
+PostScrollbackCacheIndex(const PostScrollback* scrollback, puint64 firstLine)
+{
+  puint32 i = 0;
+
+  // NOTE: line numbers are never reused so a page's first line names it
+  for (; i < POST_SCROLLBACK_CACHE_SIZE; ++i)
+    if (scrollback->cacheUse[i] && scrollback->cache[i]->firstLine == firstLine)
+      break;
+
+  return i;
+}
+
+/** releases what a cache entry holds and marks it unused, keeps the memory */
+static void
+PostScrollbackUncache(PostAppState* appState, puint32 i)
+{
+  PostScrollback*     scrollback = &appState->scrollback;
+  PostScrollbackPage* page       = scrollback->cache[i];
+
+  if (scrollback->cacheOwned[i])
+    PostAppReleaseCells(appState, page->cells, page->numCells);
+
+  scrollback->cacheOwned[i] = 0;
+  scrollback->cacheUse[i]   = 0;
+}
+
+/**
+ * releases the references of the slot's lines and empties it, returns the
+ * page memory when it can be reused right away
+ */
+static PostScrollbackPage*
+PostScrollbackDrop(PostAppState* appState, PostScrollbackSlot* slot)
+{
+  PostScrollbackPage* page = slot->page;
+
+  if (page == NULL) {
+    puint32 i = PostScrollbackCacheIndex(&appState->scrollback,
+                                         slot->packed->firstLine);
+
+    // NOTE: the unpacked copy borrows the references released here
+    if (i < POST_SCROLLBACK_CACHE_SIZE)
+      PostScrollbackUncache(appState, i);
+
+    PostScrollbackReleasePacked(appState, slot->packed);
+    free(slot->packed);
+  } else {
+    // NOTE: the thread may still be reading a queued page, which is fine for
+    // releasing but it has to be handed back before it is freed
+    PostAppReleaseCells(appState, page->cells, page->numCells);
+
+    if (page->queued) {
+      page->evicted = 1;
+      page          = NULL;
+    }
+  }
+
+  slot->page   = NULL;
+  slot->packed = NULL;
+
+  return page;
+}
+
+/** the page's own id for key, a style id or a tagged cluster, new on a miss */
+static puint32
+PostScrollbackLocalId(PostScrollbackSpiller* spiller, puint32 key)
+{
+  puint32 i = (key * 2654435761u) >> (32 - POST_SCROLLBACK_MAP_BITS);
+
+  for (;; i = (i + 1) & POST_SCROLLBACK_MAP_MASK) {
+    if (spiller->stamps[i] != spiller->stamp)
+      break;
+
+    if (spiller->keys[i] == key)
+      return spiller->values[i];
+  }
+
+  spiller->stamps[i] = spiller->stamp;
+  spiller->keys[i]   = key;
+
+  if (PostIsCluster(key)) {
+    spiller->clusters[spiller->numClusters] = key;
+    spiller->values[i] = POST_CLUSTER_TAG | spiller->numClusters++;
+  } else {
+    spiller->styles[spiller->numStyles] = key;
+    spiller->values[i]                  = spiller->numStyles++;
+  }
+
+  return spiller->values[i];
+}
+
+/**
+ * copies packed data to out with the page's own ids in place of style ids
+ * and clusters, a page's ids take at most 2 bytes so out needs room for twice
+ * the input, returns the new end of out
+ */
+static puint8*
+PostScrollbackTranslate(PostScrollbackSpiller* spiller,
+                        const puint8*          in,
+                        puint32                numLines,
+                        puint32                numCells,
+                        puint8*                out)
+{
+  puint32 value, count;
+
+  ++spiller->stamp;
+  spiller->styles[0]   = POST_STYLE_DEFAULT;
+  spiller->numStyles   = 1;
+  spiller->numClusters = 0;
+
+  for (puint32 i = 0; i < numLines; ++i) {
+    in  = PostScrollbackGetVarint(in, &value);
+    out = PostScrollbackPutVarint(out, value);
+  }
+
+  for (puint32 i = 0; i < numCells; i += count) {
+    in = PostScrollbackGetVarint(in, &value);
+    in = PostScrollbackGetVarint(in, &count);
+
+    if (value != POST_STYLE_DEFAULT)
+      value = PostScrollbackLocalId(spiller, value);
+
+    out = PostScrollbackPutVarint(out, value);
+    out = PostScrollbackPutVarint(out, count);
+  }
+
+  for (puint32 i = 0; i < numCells; i += count) {
+    in  = PostScrollbackGetVarint(in, &value);
+    in  = PostScrollbackGetVarint(in, &count);
+    out = PostScrollbackPutVarint(out, value);
+    out = PostScrollbackPutVarint(out, count);
+  }
+
+  for (puint32 i = 0; i < numCells; ++i) {
+    in = PostScrollbackGetVarint(in, &value);
+
+    if (PostIsCluster(value))
+      value = PostScrollbackLocalId(spiller, value);
+
+    out = PostScrollbackPutVarint(out, value);
+  }
+
+  return out;
+}
+
+static PostError
+PostScrollbackReserve(PostScrollbackSpiller* spiller, pusize size)
+{
+  puint8* record;
+
+  if (size <= spiller->maxRecord)
+    return POST_ERR_NONE;
+
+  record = realloc(spiller->record, size);
+  if (record == NULL)
+    return POST_ERR_OUT_OF_MEMORY;
+
+  spiller->record    = record;
+  spiller->maxRecord = size;
+
+  return POST_ERR_NONE;
+}
+
+/**
+ * appends the slot's page to the spill file, once it returns the page can be
+ * dropped and its lines are still there to read
+ */
+static PostError
+PostScrollbackSpill(PostAppState* appState, const PostScrollbackSlot* slot)
+{
+  PostScrollback*        scrollback = &appState->scrollback;
+  PostScrollbackSpiller* spiller;
+  PostScrollbackRecord   record;
+  PostScrollbackSpilled  spilled;
+  const puint8*          in;
+  pusize                 inSize, size;
+
+  if (scrollback->spiller == NULL) {
+    scrollback->spiller = calloc(1, sizeof(*scrollback->spiller));
+    if (scrollback->spiller == NULL)
+      return POST_ERR_OUT_OF_MEMORY;
+  }
+
+  spiller = scrollback->spiller;
+
+  if (spiller->scratch == NULL) {
+    spiller->scratch = malloc(POST_SCROLLBACK_PACK_BOUND);
+    if (spiller->scratch == NULL)
+      return POST_ERR_OUT_OF_MEMORY;
+  }
+
+  if (scrollback->file == NULL)
+    PostTry(PostTempFileCreate(&scrollback->file));
+
+  if (scrollback->numSpilled == scrollback->maxSpilled) {
+    puint32 maxSpilled = scrollback->maxSpilled ? scrollback->maxSpilled * 2
+                                                : 64;
+    PostScrollbackSpilled* _spilled =
+      realloc(scrollback->spilled, maxSpilled * sizeof(*_spilled));
+
+    if (_spilled == NULL)
+      return POST_ERR_OUT_OF_MEMORY;
+
+    scrollback->spilled    = _spilled;
+    scrollback->maxSpilled = maxSpilled;
+  }
+
+  if (slot->page != NULL) {
+    in                = spiller->scratch;
+    inSize            = PostScrollbackEncode(slot->page, spiller->scratch) - in;
+    spilled.firstLine = slot->page->firstLine;
+    spilled.numLines  = slot->page->numLines;
+    record.numCells   = slot->page->numCells;
+  } else {
+    in                = slot->packed->data;
+    inSize            = slot->packed->size;
+    spilled.firstLine = slot->packed->firstLine;
+    spilled.numLines  = slot->packed->numLines;
+    record.numCells   = slot->packed->numCells;
+  }
+
+  // NOTE: 3 more for padding the styles to their alignment
+  PostTry(PostScrollbackReserve(spiller, sizeof(record) + inSize * 2 + 3));
+
+  size = PostScrollbackTranslate(spiller,
+                                 in,
+                                 spilled.numLines,
+                                 record.numCells,
+                                 spiller->record + sizeof(record)) -
+         spiller->record;
+
+  record.numStyles   = spiller->numStyles - 1;
+  record.numClusters = spiller->numClusters;
+  record.packedSize  = size - sizeof(record);
+
+  for (; size % sizeof(puint32); ++size)
+    spiller->record[size] = 0;
+
+  spilled.size = size + record.numStyles * sizeof(PostStyle);
+
+  for (puint32 i = 0; i < record.numClusters; ++i) {
+    puint32 len;
+
+    PostClusterCodepoints(
+      &appState->clusters, &spiller->clusters[i], &len);
+    spilled.size += (1 + len) * sizeof(puint32);
+  }
+
+  PostTry(PostScrollbackReserve(spiller, spilled.size));
+
+  memcpy(spiller->record, &record, sizeof(record));
+
+  for (puint32 i = 1; i < spiller->numStyles; ++i, size += sizeof(PostStyle))
+    memcpy(spiller->record + size,
+           PostStyleGet(&appState->styles, spiller->styles[i]),
+           sizeof(PostStyle));
+
+  for (puint32 i = 0; i < record.numClusters; ++i) {
+    puint32        len;
+    const puint32* codepoints = PostClusterCodepoints(
+      &appState->clusters, &spiller->clusters[i], &len);
+
+    memcpy(spiller->record + size, &len, sizeof(len));
+    memcpy(spiller->record + size + sizeof(len), codepoints, len * 4);
+    size += (1 + len) * sizeof(puint32);
+  }
+
+  PostTry(PostTempFileAppend(
+    scrollback->file, spiller->record, spilled.size, &spilled.offset));
+
+  scrollback->spilled[scrollback->numSpilled++] = spilled;
+
+  return POST_ERR_NONE;
+}
+
+/**
+ * reads a spilled page back into page, its styles and clusters are interned
+ * again and its cells hold references like the ones in the ring
+ */
+static PostError
+PostScrollbackPageIn(PostAppState*                appState,
+                     const PostScrollbackSpilled* spilled,
+                     PostScrollbackPage*          page)
+{
+  PostScrollback*        scrollback = &appState->scrollback;
+  PostScrollbackSpiller* spiller    = scrollback->spiller;
+  PostTempFileView       view;
+  PostScrollbackRecord   record;
+  const puint8*          styles;
+  const puint32*         clusters;
+
+  PostTry(PostTempFileMap(
+    scrollback->file, spilled->offset, spilled->size, &view));
+
+  memcpy(&record, view.data, sizeof(record));
+
+  styles = view.data + sizeof(record) +
+           (record.packedSize + sizeof(puint32) - 1) / sizeof(puint32) *
+             sizeof(puint32);
+  clusters =
+    (const puint32*) (styles + record.numStyles * sizeof(PostStyle));
+
+  spiller->styles[0] = POST_STYLE_DEFAULT;
+
+  for (puint32 i = 0; i < record.numStyles; ++i) {
+    PostStyle style;
+
+    memcpy(&style, styles + i * sizeof(PostStyle), sizeof(style));
+
+    // NOTE: with the table full the lines come back in the default style
+    if (PostStyleIntern(&appState->styles, &style, &spiller->styles[i + 1]) !=
+        POST_ERR_NONE)
+      spiller->styles[i + 1] = POST_STYLE_DEFAULT;
+  }
+
+  for (puint32 i = 0; i < record.numClusters; ++i) {
+    puint32 len = *clusters++, charCode = clusters[0];
+
+    // NOTE: if the table can't grow the cell keeps what it has so far
+    for (puint32 j = 1; j < len; ++j)
+      PostClusterExtend(&appState->clusters, &charCode, clusters[j]);
+
+    spiller->clusters[i] = charCode;
+    clusters += len;
+  }
+
+  PostScrollbackUnpack(view.data + sizeof(record),
+                       spilled->firstLine,
+                       spilled->numLines,
+                       record.numCells,
+                       spiller->styles,
+                       spiller->clusters,
+                       page);
+
+  PostTempFileUnmap(&view);
+
+  for (puint32 i = 0; i < page->numCells; ++i) {
+    PostStyleRetain(&appState->styles, page->cells[i].style, 1);
+    PostClusterRetain(&appState->clusters, page->cells[i].charCode);
+  }
+
+  // NOTE: the cells hold their own references now
+  for (puint32 i = 1; i <= record.numStyles; ++i)
+    PostStyleRelease(&appState->styles, spiller->styles[i], 1);
+
+  for (puint32 i = 0; i < record.numClusters; ++i)
+    PostClusterRelease(&appState->clusters, spiller->clusters[i]);
+
+  return POST_ERR_NONE;
+}
+
+/** forgets every spilled page, the next spill starts a new file */
+static void
+PostScrollbackDropSpilled(PostAppState* appState)
+{
+  PostScrollback* scrollback = &appState->scrollback;
+
+  for (puint32 i = 0; i < POST_SCROLLBACK_CACHE_SIZE; ++i)
+    if (scrollback->cacheOwned[i])
+      PostScrollbackUncache(appState, i);
+
+  for (puint32 i = 0; i < scrollback->numSpilled; ++i)
+    scrollback->numLines -= scrollback->spilled[i].numLines;
+
+  if (scrollback->file != NULL)
+    PostTempFileDestroy(scrollback->file);
+
+  free(scrollback->spilled);
+
+  scrollback->file       = NULL;
+  scrollback->spilled    = NULL;
+  scrollback->numSpilled = 0;
+  scrollback->maxSpilled = 0;
+}
+
+void
+PostScrollbackInit(PostScrollback* scrollback, pusize maxBytes, pbool spill)
+{
+  memset(scrollback, 0, sizeof(*scrollback));
+
+  scrollback->maxPages = maxBytes / POST_SCROLLBACK_PAGE_SIZE;
+  scrollback->spill    = spill;
+
+  atomic_init(&scrollback->running, 0);
+  atomic_init(&scrollback->jobHead, 0);
+  atomic_init(&scrollback->resultHead, 0);
+}
+
+void
+PostScrollbackFini(PostScrollback* scrollback)
+{
+  if (scrollback->thread != NULL) {
+    atomic_store_explicit(&scrollback->running, 0, memory_order_release);
+    PostEventSignal(scrollback->wake);
+    PostThreadJoin(scrollback->thread);
+    PostEventDestroy(scrollback->wake);
+
+    scrollback->thread = NULL;
+    scrollback->wake   = NULL;
+  }
+
+  PostScrollbackCollect(scrollback);
+
+  // NOTE: jobs the thread never got to are still in the ring unless they
+  // were evicted
+  for (puint32 i = scrollback->jobTail;
+       i != atomic_load_explicit(&scrollback->jobHead, memory_order_relaxed);
+       ++i) {
+    PostScrollbackPage* page = scrollback->jobs[i & POST_SCROLLBACK_QUEUE_MASK];
+
+    if (page->evicted)
+      free(page);
+  }
+
+  for (puint32 i = 0; i < scrollback->numPages; ++i) {
+    PostScrollbackSlot* slot = PostScrollbackSlotAt(scrollback, i);
+
+    free(slot->page);
+    free(slot->packed);
+  }
+
+  // NOTE: the references of cached spilled pages go with the tables
+  for (puint32 i = 0; i < POST_SCROLLBACK_CACHE_SIZE; ++i)
+    free(scrollback->cache[i]);
+
+  if (scrollback->file != NULL)
+    PostTempFileDestroy(scrollback->file);
+
+  if (scrollback->spiller != NULL) {
+    free(scrollback->spiller->scratch);
+    free(scrollback->spiller->record);
+    free(scrollback->spiller);
+  }
+
+  free(scrollback->spilled);
+  free(scrollback->spare);
+  free(scrollback->slots);
+
+  PostScrollbackInit(scrollback,
+                     (pusize) scrollback->maxPages * POST_SCROLLBACK_PAGE_SIZE,
+                     scrollback->spill);
+}
+
+/**
+ * appends an empty page to the ring, dropping the oldest page once the ring
+ * is full, returns NULL when the scrollback is off or out of memory
+ */
+static PostScrollbackPage*
+PostScrollbackNextPage(PostAppState* appState)
+{
+  PostScrollback*     scrollback = &appState->scrollback;
+  PostScrollbackPage* page       = NULL;
+  PostScrollbackSlot* slot;
+
+  if (!scrollback->maxPages)
+    return NULL;
+
+  if (scrollback->slots == NULL) {
+    scrollback->slots =
+      calloc(scrollback->maxPages, sizeof(*scrollback->slots));
+    if (scrollback->slots == NULL)
+      return NULL;
+  }
+
+  PostScrollbackCollect(scrollback);
+
+  if (scrollback->numPages == scrollback->maxPages) {
+    slot = PostScrollbackSlotAt(scrollback, 0);
+
+    if (scrollback->spill) {
+      PostError error = PostScrollbackSpill(appState, slot);
+
+      // NOTE: spilled lines have to run on into the ring, so without room on
+      // disk the history goes back to fitting in memory
+      if (error != POST_ERR_NONE) {
+        PostAppLogWarning(
+          appState, "Scrollback Spill Failed: %s", PostErrorString(error));
+        PostScrollbackDropSpilled(appState);
+        scrollback->spill = 0;
+      }
+    }
+
+    if (!scrollback->spill)
+      scrollback->numLines -= PostScrollbackSlotLines(slot);
+
+    page = PostScrollbackDrop(appState, slot);
+
+    if (++scrollback->firstPage == scrollback->maxPages)
+      scrollback->firstPage = 0;
+    --scrollback->numPages;
+  }
+
+  if (page == NULL) {
+    page              = scrollback->spare;
+    scrollback->spare = NULL;
+  }
+
+  if (page == NULL)
+    page = malloc(POST_SCROLLBACK_PAGE_SIZE);
+
+  if (page == NULL)
+    return NULL;
+
+  page->firstLine = scrollback->nextLine;
+  page->numLines  = 0;
+  page->numCells  = 0;
+  page->queued    = 0;
+  page->evicted   = 0;
+
+  slot = PostScrollbackSlotAt(scrollback, scrollback->numPages++);
+  *slot = (PostScrollbackSlot) { .page = page };
+
+  PostScrollbackQueue(scrollback);
+
+  return page;
+}
+
+/** the newest page, NULL when there is none or it is compressed */
+static inline PostScrollbackPage*
+PostScrollbackLastPage(const PostScrollback* scrollback)
+{
+  if (!scrollback->numPages)
+    return NULL;
+
+  return PostScrollbackSlotAt(scrollback, scrollback->numPages - 1)->page;
+}
+
+void
+PostScrollbackPush(PostAppState*   appState,
+                   const PostCell* cells,
+                   puint32         len,
+                   pbool           wrapped)
+{
+  PostScrollback*     scrollback = &appState->scrollback;
+  PostScrollbackPage* page       = PostScrollbackLastPage(scrollback);
+  puint16*            offset;
+
+  if (len > POST_SCROLLBACK_PAGE_CELLS) {
+    PostAppReleaseCells(appState,
+                        cells + POST_SCROLLBACK_PAGE_CELLS,
+                        len - POST_SCROLLBACK_PAGE_CELLS);
+    len = POST_SCROLLBACK_PAGE_CELLS;
+  }
+
+  // NOTE: a row that continues a wrapped line is joined onto it so lines do
+  // not depend on the width they were written at, a line that does not fit
+  // goes on in the next page and keeps its flag
+  if (page != NULL && page->numLines &&
+      PostScrollbackLineWrapped(page, page->numLines - 1) &&
+      PostScrollbackFits(page, len)) {
+    offset = PostScrollbackOffset(page, page->numLines - 1);
+  } else {
+    if (page == NULL || !PostScrollbackFits(page, len))
+      page = PostScrollbackNextPage(appState);
+
+    // NOTE: with no page to put it in the line is dropped like it would be
+    // without a scrollback
+    if (page == NULL) {
+      PostAppReleaseCells(appState, cells, len);
+      return;
+    }
+
+    offset  = PostScrollbackOffset(page, page->numLines++);
+    *offset = page->numCells;
+    ++scrollback->numLines;
+    ++scrollback->nextLine;
+  }
+
+  memcpy(page->cells + page->numCells, cells, len * sizeof(PostCell));
+  page->numCells += len;
+
+  if (wrapped)
+    *offset |= POST_SCROLLBACK_WRAPPED;
+  else
+    *offset &= ~POST_SCROLLBACK_WRAPPED;
+}
+
+const PostCell*
+PostScrollbackPopWrapped(PostAppState* appState, puint32* len)
+{
+  PostScrollback*     scrollback = &appState->scrollback;
+  PostScrollbackPage* page       = PostScrollbackLastPage(scrollback);
+  puint32             start;
+
+  *len = 0;
+
+  if (page == NULL || !page->numLines ||
+      !PostScrollbackLineWrapped(page, page->numLines - 1))
+    return NULL;
+
+  start          = PostScrollbackLineStart(page, page->numLines - 1);
+  *len           = page->numCells - start;
+  page->numCells = start;
+
+  --page->numLines;
+  --scrollback->numLines;
+  --scrollback->nextLine;
+
+  // NOTE: an empty page would have the same first line as the next one, it
+  // becomes the spare and the cells stay put until the next push
+  if (!page->numLines) {
+    --scrollback->numPages;
+    free(scrollback->spare);
+    scrollback->spare = page;
+  }
+
+  return page->cells + start;
+}
+
+void
+PostScrollbackEndLine(PostScrollback* scrollback)
+{
+  PostScrollbackPage* page = PostScrollbackLastPage(scrollback);
+
+  if (page != NULL && page->numLines)
+    *PostScrollbackOffset(page, page->numLines - 1) &=
+      ~POST_SCROLLBACK_WRAPPED;
+}
+
+void
+PostScrollbackClear(PostAppState* appState)
+{
+  PostScrollback* scrollback = &appState->scrollback;
+
+  PostScrollbackCollect(scrollback);
+
+  for (puint32 i = 0; i < scrollback->numPages; ++i)
+    free(PostScrollbackDrop(appState, PostScrollbackSlotAt(scrollback, i)));
+
+  PostScrollbackDropSpilled(appState);
+  free(scrollback->spare);
+
+  scrollback->spare     = NULL;
+  scrollback->firstPage = 0;
+  scrollback->numPages  = 0;
+  scrollback->numLines  = 0;
+}
+
+/** the spilled page holding line, a bisection like PostScrollbackFindSlot */
+static const PostScrollbackSpilled*
+PostScrollbackFindSpilled(const PostScrollback* scrollback, puint64 line)
+{
+  puint32 lo = 0, hi = scrollback->numSpilled - 1;
+
+  while (lo < hi) {
+    puint32 mid = lo + (hi - lo + 1) / 2;
+
+    if (scrollback->spilled[mid].firstLine <= line)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+
+  return scrollback->spilled + lo;
+}
+
+/**
+ * the unpacked copy of a compressed or a spilled page, exactly one of packed
+ * and spilled is set, the page is unpacked or read back on a miss
+ */
+static PostScrollbackPage*
+PostScrollbackCached(PostAppState*                appState,
+                     const PostScrollbackPacked*  packed,
+                     const PostScrollbackSpilled* spilled)
+{
+  PostScrollback* scrollback = &appState->scrollback;
+  puint32         victim     = PostScrollbackCacheIndex(
+    scrollback, packed != NULL ? packed->firstLine : spilled->firstLine);
+
+  if (victim < POST_SCROLLBACK_CACHE_SIZE) {
+    scrollback->cacheUse[victim] = ++scrollback->cacheClock;
+    return scrollback->cache[victim];
+  }
+
+  // NOTE: entries never used have a use of 0 and go first
+  victim = 0;
+
+  for (puint32 i = 1; i < POST_SCROLLBACK_CACHE_SIZE; ++i)
+    if (scrollback->cacheUse[i] < scrollback->cacheUse[victim])
+      victim = i;
+
+  if (scrollback->cache[victim] == NULL) {
+    scrollback->cache[victim] = malloc(POST_SCROLLBACK_PAGE_SIZE);
+    if (scrollback->cache[victim] == NULL)
+      return NULL;
+  }
+
+  PostScrollbackUncache(appState, victim);
+
+  if (packed != NULL)
+    PostScrollbackUnpack(packed->data,
+                         packed->firstLine,
+                         packed->numLines,
+                         packed->numCells,
+                         NULL,
+                         NULL,
+                         scrollback->cache[victim]);
+  else if (PostScrollbackPageIn(appState, spilled, scrollback->cache[victim]) ==
+           POST_ERR_NONE)
+    scrollback->cacheOwned[victim] = 1;
+  else
+    return NULL;
+
+  scrollback->cacheUse[victim] = ++scrollback->cacheClock;
+
+  return scrollback->cache[victim];
+}
+
+const PostCell*
+PostScrollbackLine(PostAppState* appState,
+                   puint64       i,
+                   puint32*      len,
+                   pbool*        wrapped)
+{
+  PostScrollback*           scrollback = &appState->scrollback;
+  const PostScrollbackSlot* slot;
+  const PostScrollbackPage* page;
+  puint64                   line;
+  puint32                   start;
+
+  *len = 0;
+
+  if (i >= scrollback->numLines)
+    return NULL;
+
+  line = scrollback->nextLine - 1 - i;
+  slot = scrollback->numPages ? PostScrollbackSlotAt(scrollback, 0) : NULL;
+
+  // NOTE: spilled lines are the oldest, everything from the ring's first
+  // page on is still in memory
+  if (slot != NULL && line >= PostScrollbackSlotFirstLine(slot)) {
+    slot = PostScrollbackFindSlot(scrollback, line);
+    page = slot->page;
+
+    if (page == NULL)
+      page = PostScrollbackCached(appState, slot->packed, NULL);
+  } else
+    page = PostScrollbackCached(
+      appState, NULL, PostScrollbackFindSpilled(scrollback, line));
+
+  if (page == NULL)
+    return NULL;
+
+  i     = line - page->firstLine;
+  start = PostScrollbackLineStart(page, i);
+  *len  = PostScrollbackLineEnd(page, i) - start;
+
+  if (wrapped != NULL)
+    *wrapped = PostScrollbackLineWrapped(page, i);
+
+  return page->cells + start;
+}
@@ -51,19 +51,13 @@ PostSDLAppCreate(PostAppState** appState)
   if (_appState == NULL || renderer == NULL)
     goto fail;
 
-  memset(_appState, 0, sizeof(PostAppState));
-
-  PostLoadConfig(&_appState->config);
-
-  _appState->parser.state = POST_PARSER_STATE_NORMAL;
-
-  _appState->cursor.fg = _appState->config.fg;
-  _appState->cursor.bg = _appState->config.bg;
+  PostAppInit(_appState);
 
   _appState->renderer = (PostRenderer*) renderer;
 
   _appState->LogInfo    = PostSDLAppLogInfo;
   _appState->LogWarning = PostSDLAppLogWarning;
+  _appState->Reply      = PostChildProcessSend;
   _appState->DestroyApp = PostSDLAppDestroy;
 
   memset(renderer, 0, sizeof(PostSDLRenderer));
@@ -72,6 +66,8 @@ PostSDLAppCreate(PostAppState** appState)
   renderer->base.windowHeight = HEIGHT;
 
   renderer->base.SetWindowTitle = PostSDLSetTitle;
+  renderer->base.SetClipboard   = PostSDLSetClipboard;
+  renderer->base.GetClipboard   = PostSDLGetClipboard;
   renderer->base.RenderFrame    = PostSDLRenderFrame;
 
   error = PostChildProcessSpawn(
@@ -97,14 +93,6 @@ PostSDLAppCreate(PostAppState** appState)
   if (error != POST_ERR_NONE)
     goto fail;
 
-  renderer->glyphBitmap =
-    malloc(renderer->base.cellWidth * renderer->base.cellHeight);
-
-  if (renderer->glyphBitmap == NULL) {
-    error = POST_ERR_OUT_OF_MEMORY;
-    goto fail;
-  }
-
   error = PostAppSizeGrid(_appState);
 
   if (error != POST_ERR_NONE)
@@ -135,18 +123,29 @@ PostSDLAppCreate(PostAppState** appState)
   SDL_SetRenderLogicalPresentation(
     renderer->sdlRenderer, 0, 0, SDL_LOGICAL_PRESENTATION_DISABLED);
   SDL_SetRenderDrawBlendMode(renderer->sdlRenderer, SDL_BLENDMODE_BLEND);
+  PostSDLAtlasInit(&renderer->atlas, renderer->sdlRenderer);
+  PostSDLBatchInit(&renderer->batch);
+  PostSDLRowCacheInit(&renderer->rowCache,
+                      renderer->sdlRenderer,
+                      _appState->config.rowCacheSize);
+
+  renderer->atlas.BeforeEvict = PostSDLFlushBatch;
+  renderer->atlas.evictData   = renderer;
   SDL_StartTextInput(renderer->sdlWindow);
 
+  // NOTE: started last so the failure path never has a thread to stop
+  error = PostAppStartLogging(_appState);
+
+  if (error != POST_ERR_NONE)
+    goto fail;
+
   *appState = _appState;
 
   return POST_ERR_NONE;
 
 fail:
-  if (renderer != NULL) {
-    if (renderer->glyphBitmap != NULL)
-      free(renderer->glyphBitmap);
+  if (renderer != NULL)
     free(renderer);
-  }
 
   if (_appState != NULL)
     free(_appState);
@@ -155,24 +154,39 @@ fail:
 }
 
 void
-PostSDLAppLogInfo(UNUSED PostAppState* appState, const char* fmt, va_list args)
+PostSDLAppLogInfo(UNUSED PostAppState* appState, const char* message)
 {
-  SDL_LogMessageV(
-    SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO, fmt, args);
+  SDL_LogMessage(
+    SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO, "%s", message);
 }
 
 void
-PostSDLAppLogWarning(UNUSED PostAppState* appState,
-                     const char*          fmt,
-                     va_list              args)
+PostSDLAppLogWarning(UNUSED PostAppState* appState, const char* message)
 {
-  SDL_LogMessageV(
-    SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_WARN, fmt, args);
+  SDL_LogMessage(
+    SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_WARN, "%s", message);
 }
 
 void
 PostSDLAppDestroy(PostAppState* appState)
 {
+  PostSDLRenderer* renderer = (PostSDLRenderer*) appState->renderer;
+
+  PostAppLogInfo(appState,
+                 "Row Cache: %llu Hits, %llu Misses",
+                 (unsigned long long) renderer->rowCache.hits,
+                 (unsigned long long) renderer->rowCache.misses);
+
+  PostSDLAtlasFini(&renderer->atlas);
+  PostSDLBatchFini(&renderer->batch);
+  PostSDLRowCacheFini(&renderer->rowCache);
+
+  if (renderer->target != NULL)
+    SDL_DestroyTexture(renderer->target);
+
+  if (renderer->backTarget != NULL)
+    SDL_DestroyTexture(renderer->backTarget);
+
   if (appState->childProcess != NULL)
     PostProcessDestroy(appState->childProcess);
 
@@ -180,5 +194,6 @@ PostSDLAppDestroy(PostAppState* appState)
     fclose(appState->master);
 
   PostFontSystemFini();
+  PostAppFini(appState);
   free(appState);
 }
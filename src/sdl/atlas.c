@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "post/sdl/atlas.h"
+#include "post/sdl/log.h"
+
+#define POST_SDL_ATLAS_HASH 0x9E3779B97F4A7C15ull
+
+#define MIN(X, Y) ((X) < (Y) ? (X) : (Y))
+
+static puint64
+PostSDLAtlasKey(puint32 face, puint32 codepoint, puint32 width, puint32 height)
+{
+  return codepoint | (puint64) face << 21 | (puint64) width << 29 |
+         (puint64) height << 45;
+}
+
+static puint32*
+PostSDLAtlasFindSlot(PostSDLAtlas* atlas, puint64 key)
+{
+  puint32 mask = atlas->numSlots - 1;
+  puint32 i    = (key * POST_SDL_ATLAS_HASH) >> 32 & mask;
+
+  while (atlas->slots[i] && atlas->glyphs[atlas->slots[i] - 1].key != key)
+    i = (i + 1) & mask;
+
+  return &atlas->slots[i];
+}
+
+static PostError
+PostSDLAtlasRehash(PostSDLAtlas* atlas, puint32 numSlots)
+{
+  if (numSlots != atlas->numSlots) {
+    puint32* slots = realloc(atlas->slots, numSlots * sizeof(puint32));
+
+    if (slots == NULL)
+      return POST_ERR_OUT_OF_MEMORY;
+
+    atlas->slots    = slots;
+    atlas->numSlots = numSlots;
+  }
+
+  memset(atlas->slots, 0, atlas->numSlots * sizeof(puint32));
+
+  for (puint32 i = 0; i < atlas->numGlyphs; ++i)
+    *PostSDLAtlasFindSlot(atlas, atlas->glyphs[i].key) = i + 1;
+
+  return POST_ERR_NONE;
+}
+
+/** drops the glyphs packed into page so it can be packed again */
+static void
+PostSDLAtlasEvictPage(PostSDLAtlas* atlas, puint16 page)
+{
+  puint32 numGlyphs = 0;
+
+  for (puint32 i = 0; i < atlas->numGlyphs; ++i) {
+    if (atlas->glyphs[i].page != page)
+      atlas->glyphs[numGlyphs++] = atlas->glyphs[i];
+  }
+
+  atlas->numGlyphs              = numGlyphs;
+  atlas->pages[page].numShelves = 0;
+
+  // NOTE: the map only shrinks, so rehashing in place never fails
+  PostSDLAtlasRehash(atlas, atlas->numSlots);
+}
+
+static pbool
+PostSDLAtlasPackShelf(PostSDLAtlasPage* page,
+                      puint32           width,
+                      puint32           height,
+                      PostSDLGlyph*     glyph)
+{
+  PostSDLAtlasShelf* best = NULL;
+
+  // NOTE: the lowest shelf the glyph fits on wastes the least space
+  for (puint32 i = 0; i < page->numShelves; ++i) {
+    PostSDLAtlasShelf* shelf = &page->shelves[i];
+
+    if (shelf->height >= height &&
+        shelf->x + width <= POST_SDL_ATLAS_PAGE_SIZE &&
+        (best == NULL || shelf->height < best->height))
+      best = shelf;
+  }
+
+  if (best == NULL) {
+    puint32 y = 0;
+
+    if (page->numShelves == POST_SDL_ATLAS_MAX_SHELVES)
+      return 0;
+
+    if (page->numShelves) {
+      PostSDLAtlasShelf* last = &page->shelves[page->numShelves - 1];
+      y                       = last->y + last->height;
+    }
+
+    if (y + height > POST_SDL_ATLAS_PAGE_SIZE)
+      return 0;
+
+    best  = &page->shelves[page->numShelves++];
+    *best = (PostSDLAtlasShelf) { .y = y, .height = height, .x = 0 };
+  }
+
+  glyph->x = best->x;
+  glyph->y = best->y;
+  best->x += width;
+
+  return 1;
+}
+
+static PostError
+PostSDLAtlasPack(PostSDLAtlas* atlas, PostSDLGlyph* glyph)
+{
+  PostSDLAtlasPage* page;
+  puint16           lru = 0;
+
+  for (puint16 i = 0; i < atlas->numPages; ++i) {
+    if (PostSDLAtlasPackShelf(
+          &atlas->pages[i], glyph->width, glyph->height, glyph)) {
+      glyph->page = i;
+      return POST_ERR_NONE;
+    }
+
+    if (atlas->pages[i].lastUse < atlas->pages[lru].lastUse)
+      lru = i;
+  }
+
+  if (atlas->numPages < POST_SDL_ATLAS_MAX_PAGES) {
+    page          = &atlas->pages[atlas->numPages];
+    page->texture = SDL_CreateTexture(atlas->sdlRenderer,
+                                      SDL_PIXELFORMAT_RGBA32,
+                                      SDL_TEXTUREACCESS_STATIC,
+                                      POST_SDL_ATLAS_PAGE_SIZE,
+                                      POST_SDL_ATLAS_PAGE_SIZE);
+
+    if (page->texture == NULL) {
+      PostLogErrorA("Could Not Create Glyph Atlas Page: %s", SDL_GetError());
+      return POST_ERR_SUBSYS;
+    }
+
+    SDL_SetTextureBlendMode(page->texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(page->texture, SDL_SCALEMODE_NEAREST);
+
+    page->numShelves = 0;
+    lru              = atlas->numPages++;
+  } else {
+    if (atlas->BeforeEvict != NULL)
+      PostTry(atlas->BeforeEvict(atlas->evictData));
+
+    PostSDLAtlasEvictPage(atlas, lru);
+  }
+
+  atlas->pages[lru].lastUse = atlas->frame;
+
+  // NOTE: a glyph always fits an empty page, it is cut to the page size
+  PostSDLAtlasPackShelf(&atlas->pages[lru], glyph->width, glyph->height, glyph);
+  glyph->page = lru;
+
+  return POST_ERR_NONE;
+}
+
+static PostError
+PostSDLAtlasUpload(PostSDLAtlas*          atlas,
+                   const PostSDLGlyph*    glyph,
+                   const PostGlyphBitmap* bitmap)
+{
+  puint32 size = glyph->width * glyph->height * 4;
+  puint8* pixel;
+
+  if (size > atlas->stagingSize) {
+    puint8* staging = realloc(atlas->staging, size);
+
+    if (staging == NULL)
+      return POST_ERR_OUT_OF_MEMORY;
+
+    atlas->staging     = staging;
+    atlas->stagingSize = size;
+  }
+
+  pixel = atlas->staging;
+
+  // NOTE: SDL has no alpha only format every renderer takes, so the coverage
+  // goes in the alpha of white pixels and the colour comes from the color mod
+  for (puint32 y = 0; y < glyph->height; ++y) {
+    const puint8* row = bitmap->bitmap + (pint32) y * bitmap->pitch;
+
+    for (puint32 x = 0; x < glyph->width; ++x) {
+      pixel[0] = pixel[1] = pixel[2] = 0xFF;
+      pixel[3]                       = row[x];
+      pixel += 4;
+    }
+  }
+
+  SDL_Rect rect = (SDL_Rect) {
+    .x = glyph->x, .y = glyph->y, .w = glyph->width, .h = glyph->height
+  };
+
+  if (!SDL_UpdateTexture(atlas->pages[glyph->page].texture,
+                         &rect,
+                         atlas->staging,
+                         glyph->width * 4)) {
+    PostLogErrorA("Could Not Update Glyph Atlas Page: %s", SDL_GetError());
+    return POST_ERR_SUBSYS;
+  }
+
+  return POST_ERR_NONE;
+}
+
+void
+PostSDLAtlasInit(PostSDLAtlas* atlas, SDL_Renderer* sdlRenderer)
+{
+  memset(atlas, 0, sizeof(PostSDLAtlas));
+  atlas->sdlRenderer = sdlRenderer;
+}
+
+void
+PostSDLAtlasFini(PostSDLAtlas* atlas)
+{
+  for (puint32 i = 0; i < atlas->numPages; ++i)
+    SDL_DestroyTexture(atlas->pages[i].texture);
+
+  free(atlas->glyphs);
+  free(atlas->slots);
+  free(atlas->staging);
+
+  memset(atlas, 0, sizeof(PostSDLAtlas));
+}
+
+void
+PostSDLAtlasClear(PostSDLAtlas* atlas)
+{
+  for (puint32 i = 0; i < atlas->numPages; ++i) {
+    SDL_DestroyTexture(atlas->pages[i].texture);
+    atlas->pages[i] = (PostSDLAtlasPage) { 0 };
+  }
+
+  atlas->numPages  = 0;
+  atlas->numGlyphs = 0;
+
+  if (atlas->slots != NULL)
+    memset(atlas->slots, 0, atlas->numSlots * sizeof(puint32));
+}
+
+PostError
+PostSDLAtlasGet(PostSDLAtlas*        atlas,
+                PostFont*            font,
+                puint32              face,
+                puint32              codepoint,
+                puint32              width,
+                puint32              height,
+                const PostSDLGlyph** glyph)
+{
+  PostError       error;
+  PostGlyphBitmap bitmap;
+  PostSDLGlyph*   entry;
+  puint32*        slot;
+  puint64         key = PostSDLAtlasKey(face, codepoint, width, height);
+
+  if (atlas->numSlots) {
+    slot = PostSDLAtlasFindSlot(atlas, key);
+
+    if (*slot) {
+      entry = &atlas->glyphs[*slot - 1];
+
+      if (entry->page != POST_SDL_ATLAS_NO_PAGE)
+        atlas->pages[entry->page].lastUse = atlas->frame;
+
+      *glyph = entry;
+      return POST_ERR_NONE;
+    }
+  }
+
+  // NOTE: the map is kept at most half full so probes stay short
+  if ((atlas->numGlyphs + 1) * 2 > atlas->numSlots) {
+    error =
+      PostSDLAtlasRehash(atlas, atlas->numSlots ? atlas->numSlots * 2 : 256);
+
+    if (error != POST_ERR_NONE)
+      return error;
+  }
+
+  if (atlas->numGlyphs == atlas->maxGlyphs) {
+    puint32       maxGlyphs = atlas->maxGlyphs ? atlas->maxGlyphs * 2 : 128;
+    PostSDLGlyph* glyphs =
+      realloc(atlas->glyphs, maxGlyphs * sizeof(PostSDLGlyph));
+
+    if (glyphs == NULL)
+      return POST_ERR_OUT_OF_MEMORY;
+
+    atlas->glyphs    = glyphs;
+    atlas->maxGlyphs = maxGlyphs;
+  }
+
+  error = PostFontRenderGlyph(font,
+                              codepoint,
+                              MIN(width, POST_SDL_ATLAS_PAGE_SIZE),
+                              MIN(height, POST_SDL_ATLAS_PAGE_SIZE),
+                              &bitmap);
+
+  if (error != POST_ERR_NONE)
+    return error;
+
+  PostSDLGlyph added = (PostSDLGlyph) {
+    .key     = key,
+    .page    = POST_SDL_ATLAS_NO_PAGE,
+    .width   = bitmap.width,
+    .height  = bitmap.height,
+    .left    = bitmap.left,
+    .top     = bitmap.top,
+    .missing = !PostFontHasGlyph(font, codepoint),
+  };
+
+  if (added.width && added.height) {
+    error = PostSDLAtlasPack(atlas, &added);
+
+    if (error == POST_ERR_NONE)
+      error = PostSDLAtlasUpload(atlas, &added, &bitmap);
+
+    if (error != POST_ERR_NONE)
+      return error;
+  }
+
+  // NOTE: packing may have evicted a page and moved the glyphs around
+  entry  = &atlas->glyphs[atlas->numGlyphs++];
+  *entry = added;
+  *PostSDLAtlasFindSlot(atlas, key) = atlas->numGlyphs;
+  *glyph                            = entry;
+
+  return POST_ERR_NONE;
+}
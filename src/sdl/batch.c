@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "post/sdl/batch.h"
+#include "post/sdl/log.h"
+
+static PostError
+PostSDLBatchQuad(PostSDLBatch* batch,
+                 puint32       layer,
+                 SDL_FRect     dst,
+                 SDL_FRect     src,
+                 PostColor     color)
+{
+  PostSDLBatchLayer* _layer = &batch->layers[layer];
+  SDL_Vertex*        vertex;
+  int*               index;
+  int                first = batch->numVertices;
+
+  if (batch->numVertices + 4 > batch->maxVertices) {
+    puint32 maxVertices = batch->maxVertices ? batch->maxVertices * 2 : 4096;
+    SDL_Vertex* vertices =
+      realloc(batch->vertices, maxVertices * sizeof(SDL_Vertex));
+
+    if (vertices == NULL)
+      return POST_ERR_OUT_OF_MEMORY;
+
+    batch->vertices    = vertices;
+    batch->maxVertices = maxVertices;
+  }
+
+  if (_layer->numIndices + 6 > _layer->maxIndices) {
+    puint32 maxIndices = _layer->maxIndices ? _layer->maxIndices * 2 : 6144;
+    int*    indices    = realloc(_layer->indices, maxIndices * sizeof(int));
+
+    if (indices == NULL)
+      return POST_ERR_OUT_OF_MEMORY;
+
+    _layer->indices    = indices;
+    _layer->maxIndices = maxIndices;
+  }
+
+  SDL_FColor fcolor = (SDL_FColor) { .r = color.r / 255.0f,
+                                     .g = color.g / 255.0f,
+                                     .b = color.b / 255.0f,
+                                     .a = color.a / 255.0f };
+
+  vertex = &batch->vertices[batch->numVertices];
+  batch->numVertices += 4;
+
+  for (puint32 i = 0; i < 4; ++i) {
+    float right  = i & 1;
+    float bottom = i >> 1;
+
+    vertex[i] = (SDL_Vertex) {
+      .position  = { dst.x + dst.w * right, dst.y + dst.h * bottom },
+      .color     = fcolor,
+      .tex_coord = { src.x + src.w * right, src.y + src.h * bottom },
+    };
+  }
+
+  index = &_layer->indices[_layer->numIndices];
+  _layer->numIndices += 6;
+
+  index[0] = first;
+  index[1] = first + 1;
+  index[2] = first + 2;
+  index[3] = first + 2;
+  index[4] = first + 1;
+  index[5] = first + 3;
+
+  return POST_ERR_NONE;
+}
+
+void
+PostSDLBatchInit(PostSDLBatch* batch)
+{
+  memset(batch, 0, sizeof(PostSDLBatch));
+}
+
+void
+PostSDLBatchFini(PostSDLBatch* batch)
+{
+  for (puint32 i = 0; i < POST_SDL_BATCH_LAYERS; ++i)
+    free(batch->layers[i].indices);
+
+  free(batch->vertices);
+
+  memset(batch, 0, sizeof(PostSDLBatch));
+}
+
+PostError
+PostSDLBatchFill(PostSDLBatch* batch,
+                 puint32       layer,
+                 float         x,
+                 float         y,
+                 float         width,
+                 float         height,
+                 PostColor     color)
+{
+  SDL_FRect dst = (SDL_FRect) { .x = x, .y = y, .w = width, .h = height };
+
+  return PostSDLBatchQuad(batch, layer, dst, (SDL_FRect) { 0 }, color);
+}
+
+PostError
+PostSDLBatchGlyph(PostSDLBatch*       batch,
+                  const PostSDLGlyph* glyph,
+                  float               x,
+                  float               y,
+                  PostColor           color)
+{
+  SDL_FRect dst = (SDL_FRect) { .x = x + glyph->left,
+                                .y = y + glyph->top,
+                                .w = glyph->width,
+                                .h = glyph->height };
+  SDL_FRect src = (SDL_FRect) {
+    .x = (float) glyph->x / POST_SDL_ATLAS_PAGE_SIZE,
+    .y = (float) glyph->y / POST_SDL_ATLAS_PAGE_SIZE,
+    .w = (float) glyph->width / POST_SDL_ATLAS_PAGE_SIZE,
+    .h = (float) glyph->height / POST_SDL_ATLAS_PAGE_SIZE,
+  };
+
+  return PostSDLBatchQuad(
+    batch, PostSDLBatchPage(glyph->page), dst, src, color);
+}
+
+PostError
+PostSDLBatchSubmit(PostSDLBatch* batch,
+                   SDL_Renderer* sdlRenderer,
+                   PostSDLAtlas* atlas)
+{
+  PostError error = POST_ERR_NONE;
+
+  for (puint32 i = 0; i < POST_SDL_BATCH_LAYERS; ++i) {
+    PostSDLBatchLayer* layer   = &batch->layers[i];
+    SDL_Texture*       texture = NULL;
+
+    if (!layer->numIndices)
+      continue;
+
+    if (i != POST_SDL_BATCH_UNDER && i != POST_SDL_BATCH_OVER)
+      texture = atlas->pages[i - 1].texture;
+
+    if (!SDL_RenderGeometry(sdlRenderer,
+                            texture,
+                            batch->vertices,
+                            batch->numVertices,
+                            layer->indices,
+                            layer->numIndices)) {
+      PostLogErrorA("Could Not Render Geometry: %s", SDL_GetError());
+      error = POST_ERR_SUBSYS;
+    }
+
+    layer->numIndices = 0;
+  }
+
+  batch->numVertices = 0;
+
+  return error;
+}
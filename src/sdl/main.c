@@ -26,6 +26,7 @@
 
 #include "post/proc.h"
 #include "post/sdl/app.h"
+#include "post/sdl/renderer.h"
 
 SDL_AppResult
 SDL_AppInit(void** appstate, int argc, char* argv[])
@@ -102,6 +103,31 @@ SDL_AppEvent(void* appstate, SDL_Event* event)
       PostChildProcessSend(appState, text, strlen(text));
       break;
     }
+    case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED: {
+      PostError error;
+
+      appState->renderer->windowWidth  = event->window.data1;
+      appState->renderer->windowHeight = event->window.data2;
+
+      error = PostAppSizeGrid(appState);
+
+      if (error == POST_ERR_NONE)
+        error = PostChildProcessSendWindowSize(appState);
+
+      if (error != POST_ERR_NONE)
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+                     "Error Resizing Grid: %s",
+                     PostErrorString(error));
+
+      break;
+    }
+    case SDL_EVENT_WINDOW_EXPOSED:
+    case SDL_EVENT_RENDER_TARGETS_RESET:
+      PostSDLRedraw(appState);
+      break;
+    case SDL_EVENT_RENDER_DEVICE_RESET:
+      PostSDLResetDevice(appState);
+      break;
     case SDL_EVENT_QUIT:
       return SDL_APP_SUCCESS;
   }
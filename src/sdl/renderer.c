@@ -20,11 +20,21 @@
  * IN THE SOFTWARE.
  */
 
+#include <stdlib.h>
+
 #include "post/app.h"
+#include "post/compiler.h"
 #include "post/font.h"
 #include "post/proc.h"
+#include "post/unicode.h"
 
+#include "post/sdl/batch.h"
+#include "post/sdl/log.h"
 #include "post/sdl/renderer.h"
+#include "post/sdl/rowcache.h"
+
+#define MIN(X, Y) ((X) < (Y) ? (X) : (Y))
+#define MAX(X, Y) ((X) > (Y) ? (X) : (Y))
 
 PostError
 PostSDLSetCellSize(PostSDLRenderer* renderer)
@@ -48,23 +58,424 @@ PostSDLSetTitle(PostAppState* appState, const char* title)
   return POST_ERR_NONE;
 }
 
+PostError
+PostSDLSetClipboard(UNUSED PostAppState* appState,
+                    puint8               selection,
+                    const char*          text)
+{
+  pbool ok = selection == POST_UNICODE_p ? SDL_SetPrimarySelectionText(text)
+                                         : SDL_SetClipboardText(text);
+  return ok ? POST_ERR_NONE : POST_ERR_SUBSYS;
+}
+
+PostError
+PostSDLGetClipboard(UNUSED PostAppState* appState,
+                    puint8               selection,
+                    PostString*          text)
+{
+  PostError error;
+  char*     sdlText = selection == POST_UNICODE_p
+                        ? SDL_GetPrimarySelectionText()
+                        : SDL_GetClipboardText();
+
+  if (sdlText == NULL)
+    return POST_ERR_SUBSYS;
+
+  error = PostStringAppend(text, sdlText, strlen(sdlText));
+  SDL_free(sdlText);
+
+  return error;
+}
+
+/** where the decorations sit in a cell, worked out once a frame */
+typedef struct
+{
+  pint32 thickness;
+  pint32 underline, doubleUnderline, strike;
+} PostSDLDecorations;
+
+static pbool
+PostSDLSameColor(PostColor a, PostColor b)
+{
+  return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static PostError
+PostSDLFillRun(PostSDLRenderer* renderer,
+               const PostColor* bg,
+               puint32          start,
+               puint32          end,
+               puint32          cy,
+               PostColor        color)
+{
+  puint32 cellWidth  = renderer->base.cellWidth;
+  puint32 cellHeight = renderer->base.cellHeight;
+
+  // NOTE: the default background is filled in before the runs
+  if (start == end || PostSDLSameColor(color, *bg))
+    return POST_ERR_NONE;
+
+  return PostSDLBatchFill(&renderer->batch,
+                          POST_SDL_BATCH_UNDER,
+                          start * cellWidth,
+                          cy * cellHeight,
+                          (end - start) * cellWidth,
+                          cellHeight,
+                          color);
+}
+
+/**
+ * batches the columns [start, end) of row cy over what was drawn there, its
+ * backgrounds go in first so an atlas page evicted while its glyphs are
+ * batched never leaves a background to cover them
+ */
+static PostError
+PostSDLRenderRow(PostAppState*             appState,
+                 const PostSDLDecorations* decorations,
+                 puint32                   cy,
+                 puint32                   start,
+                 puint32                   end)
+{
+  PostSDLRenderer*   renderer   = (PostSDLRenderer*) appState->renderer;
+  PostSDLBatch*      batch      = &renderer->batch;
+  const PostPalette* palette    = &appState->palette;
+  PostCellGrid*      grid       = &appState->grid;
+  const PostCell*    row        = PostGridRow(grid, cy);
+  puint32            blankFrom  = *PostGridBlankFrom(grid, cy);
+  puint32            cellWidth  = renderer->base.cellWidth;
+  puint32            cellHeight = renderer->base.cellHeight;
+  puint32            runStart, runEnd;
+  PostColor          runColor = palette->bg;
+
+  // NOTE: a wide character is drawn whole when either half is damaged
+  if (start && start < blankFrom && row[start].flags & POST_CELL_WIDE_SPACER)
+    --start;
+  if (end < blankFrom && row[end - 1].flags & POST_CELL_WIDE)
+    ++end;
+
+  PostTry(PostSDLBatchFill(batch,
+                           POST_SDL_BATCH_UNDER,
+                           start * cellWidth,
+                           cy * cellHeight,
+                           (end - start) * cellWidth,
+                           cellHeight,
+                           palette->bg));
+
+  if (end > blankFrom)
+    end = blankFrom;
+
+  runStart = runEnd = start;
+
+  // NOTE: nothing is drawn for the blank cells past a row's marker and
+  // neighbouring cells of one background are filled as one quad
+  for (puint32 cx = start; cx < end; ++cx) {
+    const PostCell*  cell = &row[cx];
+    const PostStyle* style;
+    PostColor        bg;
+    puint32          cellEnd;
+
+    if (!cell->charCode)
+      continue;
+
+    style   = PostStyleGet(&appState->styles, cell->style);
+    bg      = PostPaletteResolve(palette, style->bg, palette->bg);
+    cellEnd = cell->flags & POST_CELL_WIDE ? cx + 2 : cx + 1;
+
+    if (cx == runEnd && PostSDLSameColor(bg, runColor)) {
+      runEnd = cellEnd;
+      continue;
+    }
+
+    PostTry(
+      PostSDLFillRun(renderer, &palette->bg, runStart, runEnd, cy, runColor));
+
+    runStart = cx;
+    runEnd   = cellEnd;
+    runColor = bg;
+  }
+
+  PostTry(
+    PostSDLFillRun(renderer, &palette->bg, runStart, runEnd, cy, runColor));
+
+  for (puint32 cx = start; cx < end; ++cx) {
+    PostCell         cell = row[cx];
+    const PostStyle* style;
+    PostColor        fg, ul;
+    const puint32*   codepoints;
+    puint32          numCodepoints;
+
+    if (!cell.charCode)
+      continue;
+
+    style = PostStyleGet(&appState->styles, cell.style);
+    fg    = PostPaletteResolve(palette, style->fg, palette->fg);
+    ul    = PostPaletteResolve(palette, style->ul, fg);
+
+    puint32 glyphWidth =
+      cell.flags & POST_CELL_WIDE ? cellWidth * 2 : cellWidth;
+    puint32 rx = cx * cellWidth;
+    puint32 ry = cy * cellHeight;
+
+    codepoints = PostClusterCodepoints(
+      &appState->clusters, &cell.charCode, &numCodepoints);
+
+    // NOTE: there is no shaping, the marks of a cluster are drawn over its
+    // first codepoint and codepoints the font lacks (joiners, selectors) are
+    // skipped
+    for (puint32 i = 0; i < numCodepoints; ++i) {
+      const PostSDLGlyph* glyph;
+
+      PostTry(PostSDLAtlasGet(&renderer->atlas,
+                              &renderer->activeFont,
+                              0,
+                              codepoints[i],
+                              glyphWidth,
+                              cellHeight,
+                              &glyph));
+
+      if ((i && glyph->missing) || glyph->page == POST_SDL_ATLAS_NO_PAGE)
+        continue;
+
+      PostTry(PostSDLBatchGlyph(batch, glyph, rx, ry, fg));
+    }
+
+    if (style->sgr & POST_CELL_SGR_UNDERLINE)
+      PostTry(PostSDLBatchFill(batch,
+                               POST_SDL_BATCH_OVER,
+                               rx,
+                               ry + decorations->underline,
+                               glyphWidth,
+                               decorations->thickness,
+                               ul));
+
+    if (style->sgr & POST_CELL_SGR_DBL_UNDERLINE) {
+      PostTry(PostSDLBatchFill(batch,
+                               POST_SDL_BATCH_OVER,
+                               rx,
+                               ry + decorations->doubleUnderline,
+                               glyphWidth,
+                               decorations->thickness,
+                               ul));
+      PostTry(PostSDLBatchFill(batch,
+                               POST_SDL_BATCH_OVER,
+                               rx,
+                               ry + decorations->doubleUnderline +
+                                 decorations->thickness * 2,
+                               glyphWidth,
+                               decorations->thickness,
+                               ul));
+    }
+
+    if (style->sgr & POST_CELL_SGR_STRIKE)
+      PostTry(PostSDLBatchFill(batch,
+                               POST_SDL_BATCH_OVER,
+                               rx,
+                               ry + decorations->strike,
+                               glyphWidth,
+                               decorations->thickness,
+                               fg));
+  }
+
+  return POST_ERR_NONE;
+}
+
+PostError
+PostSDLFlushBatch(void* renderer)
+{
+  PostSDLRenderer* _renderer = renderer;
+
+  return PostSDLBatchSubmit(
+    &_renderer->batch, _renderer->sdlRenderer, &_renderer->atlas);
+}
+
+/** a hash of everything row cy draws, the key of the row cache */
+static puint64
+PostSDLHashRow(PostAppState* appState, puint32 cy)
+{
+  const PostCell* row       = PostGridRow(&appState->grid, cy);
+  puint32         blankFrom = *PostGridBlankFrom(&appState->grid, cy);
+  puint64         hash = PostSDLRowHash(POST_SDL_ROW_HASH_SEED, blankFrom);
+
+  for (puint32 x = 0; x < blankFrom; ++x) {
+    const PostStyle* style;
+    const puint32*   codepoints;
+    puint32          numCodepoints;
+
+    if (!row[x].charCode) {
+      hash = PostSDLRowHash(hash, 0);
+      continue;
+    }
+
+    style      = PostStyleGet(&appState->styles, row[x].style);
+    codepoints = PostClusterCodepoints(
+      &appState->clusters, &row[x].charCode, &numCodepoints);
+
+    for (puint32 i = 0; i < numCodepoints; ++i)
+      hash = PostSDLRowHash(hash, codepoints[i]);
+
+    // NOTE: the style is hashed by value, an id may be reused for another
+    hash = PostSDLRowHash(hash, (puint64) style->fg << 32 | style->bg);
+    hash = PostSDLRowHash(hash, (puint64) style->ul << 32 | style->sgr);
+    hash = PostSDLRowHash(hash, row[x].flags);
+  }
+
+  return hash;
+}
+
+/**
+ * makes the target the size of the window, returns whether what it holds is
+ * lost and the whole grid has to be drawn again
+ */
+static PostError
+PostSDLSizeTarget(PostAppState* appState, pbool* lost)
+{
+  PostSDLRenderer*   renderer = (PostSDLRenderer*) appState->renderer;
+  const PostPalette* palette  = &appState->palette;
+  puint32            width    = renderer->base.windowWidth;
+  puint32            height   = renderer->base.windowHeight;
+
+  // NOTE: a palette change recolours cells that did not change themselves
+  *lost = renderer->redraw ||
+          memcmp(&renderer->drawnPalette, palette, sizeof(PostPalette));
+
+  if (renderer->target == NULL || renderer->backTarget == NULL ||
+      renderer->targetWidth != width || renderer->targetHeight != height) {
+    for (puint32 i = 0; i < 2; ++i) {
+      SDL_Texture** texture = i ? &renderer->backTarget : &renderer->target;
+
+      if (*texture != NULL)
+        SDL_DestroyTexture(*texture);
+
+      *texture = SDL_CreateTexture(renderer->sdlRenderer,
+                                   SDL_PIXELFORMAT_RGBA32,
+                                   SDL_TEXTUREACCESS_TARGET,
+                                   width ? width : 1,
+                                   height ? height : 1);
+
+      if (*texture == NULL) {
+        PostLogErrorA("Could Not Create Render Target: %s", SDL_GetError());
+        return POST_ERR_SUBSYS;
+      }
+
+      SDL_SetTextureBlendMode(*texture, SDL_BLENDMODE_NONE);
+      SDL_SetTextureScaleMode(*texture, SDL_SCALEMODE_NEAREST);
+    }
+
+    renderer->targetWidth  = width;
+    renderer->targetHeight = height;
+    *lost                  = 1;
+  }
+
+  if (*lost) {
+    SDL_SetRenderTarget(renderer->sdlRenderer, renderer->target);
+    SDL_SetRenderDrawColor(renderer->sdlRenderer,
+                           palette->bg.r,
+                           palette->bg.g,
+                           palette->bg.b,
+                           palette->bg.a);
+    SDL_RenderClear(renderer->sdlRenderer);
+
+    renderer->drawnPalette = *palette;
+    renderer->redraw       = 0;
+  }
+
+  return POST_ERR_NONE;
+}
+
+/**
+ * moves what the target holds along with the scrolls the grid logged, the
+ * rows scrolled in are damaged and drawn after
+ */
+static void
+PostSDLApplyScrolls(PostSDLRenderer* renderer, PostCellGrid* grid)
+{
+  SDL_Renderer* sdlRenderer = renderer->sdlRenderer;
+  float         cellHeight  = renderer->base.cellHeight;
+
+  for (puint32 i = 0; i < grid->numScrolls; ++i) {
+    const PostGridScroll* scroll = grid->scrolls + i;
+    puint32               rows   = scroll->bottom - scroll->top + 1;
+    puint32               n      = abs(scroll->delta);
+    SDL_Texture*          front  = renderer->target;
+
+    if (!n || n >= rows)
+      continue;
+
+    SDL_FRect src = (SDL_FRect) {
+      .x = 0,
+      .y = (scroll->top + (scroll->delta > 0 ? n : 0)) * cellHeight,
+      .w = renderer->targetWidth,
+      .h = (rows - n) * cellHeight,
+    };
+    SDL_FRect dst = src;
+    dst.y = (scroll->top + (scroll->delta > 0 ? 0 : n)) * cellHeight;
+
+    // NOTE: a texture cannot be drawn into itself, the frame is copied to the
+    // back target with the region moved and the two swap
+    SDL_SetRenderTarget(sdlRenderer, renderer->backTarget);
+    SDL_RenderTexture(sdlRenderer, front, NULL, NULL);
+    SDL_RenderTexture(sdlRenderer, front, &src, &dst);
+
+    renderer->target     = renderer->backTarget;
+    renderer->backTarget = front;
+  }
+
+  grid->numScrolls = 0;
+}
+
+void
+PostSDLRedraw(PostAppState* appState)
+{
+  ((PostSDLRenderer*) appState->renderer)->redraw = 1;
+}
+
+void
+PostSDLResetDevice(PostAppState* appState)
+{
+  PostSDLRenderer* renderer = (PostSDLRenderer*) appState->renderer;
+
+  // NOTE: the glyphs are rasterized again as the next frame draws them
+  PostSDLAtlasClear(&renderer->atlas);
+
+  // NOTE: the targets are created again at the window size by the next frame
+  for (puint32 i = 0; i < 2; ++i) {
+    SDL_Texture** texture = i ? &renderer->backTarget : &renderer->target;
+
+    if (*texture != NULL)
+      SDL_DestroyTexture(*texture);
+
+    *texture = NULL;
+  }
+
+  // NOTE: the cache is sized again once the targets are
+  PostSDLRowCacheReset(&renderer->rowCache, 0, 0);
+
+  renderer->redraw = 1;
+}
+
 PostError
 PostSDLRenderFrame(PostAppState* appState)
 {
   PostSDLRenderer* renderer    = (PostSDLRenderer*) appState->renderer;
   SDL_Renderer*    sdlRenderer = renderer->sdlRenderer;
   PostFont         font        = renderer->activeFont;
-  puint8*          glyphBitmap = renderer->glyphBitmap;
+  PostError        error       = POST_ERR_NONE;
+  pbool            damaged     = 0;
+  pbool            lost;
+
+  PostCursor    cursor     = appState->cursor;
+  PostCellGrid* grid       = &appState->grid;
+  pint32        cellWidth  = renderer->base.cellWidth;
+  pint32        cellHeight = renderer->base.cellHeight;
+  pint32        thickness  = MAX(1, cellHeight / 14);
+  pint32        underline  = font.ascender + 2;
 
-  PostCursor   cursor     = appState->cursor;
-  PostCellGrid grid       = appState->grid;
-  puint32      cellWidth  = renderer->base.cellWidth;
-  puint32      cellHeight = renderer->base.cellHeight;
+  ++renderer->atlas.frame;
 
   PostChildProcessPoll(appState);
+  PostAppFlushTitle(appState);
 
-  SDL_SetRenderDrawColor(sdlRenderer, 0, 0, 0, 255);
-  SDL_RenderClear(sdlRenderer);
+  const PostPalette* palette = &appState->palette;
 
   Uint64 ticks = SDL_GetTicks();
   if (ticks - cursor.time > 500) {
@@ -72,69 +483,110 @@ PostSDLRenderFrame(PostAppState* appState)
     appState->cursor.time    = ticks;
   }
 
-  for (puint32 cy = 0; cy < grid.height; ++cy) {
-    for (puint32 cx = 0; cx < grid.width; ++cx) {
-      PostCell cell = grid.cells[cy * grid.width + cx];
+  cursor = appState->cursor;
 
-      if (!cell.charCode)
-        continue;
+  PostTry(PostSDLSizeTarget(appState, &lost));
 
-      PostError error = PostFontLoadGlyph(
-        &font, cell.charCode, cellWidth, cellHeight, cellWidth, glyphBitmap);
-
-      if (error != POST_ERR_NONE)
-        return error;
-
-      puint32 rx = cx * cellWidth;
-      puint32 ry = cy * cellHeight;
-
-      SDL_SetRenderDrawColor(
-        sdlRenderer, cell.bg.r, cell.bg.g, cell.bg.b, cell.bg.a);
-      SDL_FRect cellRect =
-        (SDL_FRect) { .x = rx, .y = ry, .w = cellWidth, .h = cellHeight };
-      SDL_RenderFillRect(sdlRenderer, &cellRect);
-
-      if (cell.sgr & POST_CELL_SGR_UNDERLINE) {
-        SDL_SetRenderDrawColor(
-          sdlRenderer, cell.fg.r, cell.fg.g, cell.fg.b, cell.fg.a);
-        SDL_RenderLine(sdlRenderer,
-                       rx,
-                       ry + font.ascender + 2,
-                       rx + cellWidth,
-                       ry + font.ascender + 2);
-      }
+  // NOTE: the rows cached were drawn with the palette and at the size of
+  // what was lost
+  if (lost) {
+    PostGridDamageRows(grid, 0, grid->height - 1);
+    PostTry(PostSDLRowCacheReset(
+      &renderer->rowCache, grid->width * cellWidth, cellHeight));
+  } else
+    PostSDLApplyScrolls(renderer, grid);
+
+  // NOTE: the lines are kept inside the cell so neighbouring rows never draw
+  // over each other
+  PostSDLDecorations decorations = {
+    .thickness       = thickness,
+    .underline       = MAX(0, MIN(underline, cellHeight - thickness)),
+    .doubleUnderline = MAX(0, MIN(underline, cellHeight - 3 * thickness)),
+    .strike          = MAX(0, font.ascender * 2 / 3),
+  };
+
+  // NOTE: only the damaged columns of the grid are drawn again, into the
+  // target that keeps the rest from the frames before
+  for (puint32 cy = 0; cy < grid->height && error == POST_ERR_NONE; ++cy) {
+    PostRowDamage* damage = grid->damage + cy;
+
+    if (damage->start >= damage->end)
+      continue;
+
+    if (!damaged)
+      SDL_SetRenderTarget(sdlRenderer, renderer->target);
+
+    damaged = 1;
 
-      for (puint32 y = 0; y < cellHeight; ++y) {
-        for (puint32 x = 0; x < cellWidth; ++x) {
-          puint8 alpha = glyphBitmap[y * cellWidth + x];
-
-          if (alpha) {
-            SDL_SetRenderDrawColor(sdlRenderer,
-                                   cell.fg.r,
-                                   cell.fg.g,
-                                   cell.fg.b,
-                                   cell.fg.a * (alpha / 255.0));
-            SDL_RenderPoint(sdlRenderer, rx + x, ry + y);
-          }
-        }
+    // NOTE: a row is only looked up when most of it is drawn again, a few
+    // cells cost less to draw than the whole row does to hash
+    if ((damage->end - damage->start) * 2 > grid->width &&
+        renderer->rowCache.numSlots) {
+      puint64 hash = PostSDLHashRow(appState, cy);
+
+      if (PostSDLRowCacheDraw(&renderer->rowCache, hash, cy * cellHeight)) {
+        *damage = (PostRowDamage) { 0 };
+        continue;
       }
+
+      error = PostSDLRowCacheDefer(&renderer->rowCache, hash, cy * cellHeight);
     }
+
+    if (error == POST_ERR_NONE)
+      error = PostSDLRenderRow(
+        appState, &decorations, cy, damage->start, damage->end);
+
+    *damage = (PostRowDamage) { 0 };
+  }
+
+  // NOTE: what was batched before a failure is still drawn, so the batch is
+  // always empty for the next frame
+  if (damaged) {
+    PostError submitted = PostSDLFlushBatch(renderer);
+
+    if (error == POST_ERR_NONE)
+      error = submitted;
+
+    // NOTE: the rows missed are copied into the cache once they are drawn
+    if (error == POST_ERR_NONE)
+      error = PostSDLRowCacheStoreRows(&renderer->rowCache, renderer->target);
   }
 
+  SDL_SetRenderTarget(sdlRenderer, NULL);
+
+  if (error != POST_ERR_NONE)
+    return error;
+
+  puint32 cx = cursor.x, cy = cursor.y;
+  if (cursor.lastColumnFlag && cursor.y + 1 < grid->height) {
+    cx = 0;
+    ++cy;
+  }
+
+  // NOTE: the cursor is drawn over the target rather than into it, so when
+  // neither changed the frame on screen is left as it is
+  if (!damaged && !lost && cursor.visible == renderer->cursorVisible &&
+      cx == renderer->cursorX && cy == renderer->cursorY)
+    return POST_ERR_NONE;
+
+  renderer->cursorVisible = cursor.visible;
+  renderer->cursorX       = cx;
+  renderer->cursorY       = cy;
+
+  SDL_RenderTexture(sdlRenderer, renderer->target, NULL, NULL);
+
   if (cursor.visible) {
-    puint32 cx = cursor.x, cy = cursor.y;
-    if (cursor.lastColumnFlag && cursor.y + 1 < grid.height) {
-      cx = 0;
-      ++cy;
-    }
+    PostColor fg =
+      PostPaletteResolve(palette, cursor.attrs.fg, palette->fg);
 
-    SDL_SetRenderDrawColor(
-      sdlRenderer, cursor.fg.r, cursor.fg.g, cursor.fg.b, cursor.fg.a);
-    SDL_RenderLine(sdlRenderer,
-                   cx * cellWidth,
-                   cy * cellHeight,
-                   cx * cellWidth,
-                   cy * cellHeight + cellHeight);
+    PostTry(PostSDLBatchFill(&renderer->batch,
+                             POST_SDL_BATCH_OVER,
+                             cx * cellWidth,
+                             cy * cellHeight,
+                             thickness,
+                             cellHeight,
+                             fg));
+    PostTry(PostSDLFlushBatch(renderer));
   }
 
   SDL_RenderPresent(sdlRenderer);
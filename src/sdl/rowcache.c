@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "post/sdl/log.h"
+#include "post/sdl/rowcache.h"
+
+static puint32
+PostSDLRowCacheHome(const PostSDLRowCache* cache, puint64 hash)
+{
+  return (puint32) (hash ^ hash >> 32) & (cache->mapSize - 1);
+}
+
+static puint32*
+PostSDLRowCacheFind(PostSDLRowCache* cache, puint64 hash)
+{
+  puint32 mask = cache->mapSize - 1;
+  puint32 i    = PostSDLRowCacheHome(cache, hash);
+
+  while (cache->map[i] && cache->slotHashes[cache->map[i] - 1] != hash)
+    i = (i + 1) & mask;
+
+  return &cache->map[i];
+}
+
+/** takes hash out of the map, moving back the entries probed past it */
+static void
+PostSDLRowCacheRemove(PostSDLRowCache* cache, puint64 hash)
+{
+  puint32  mask = cache->mapSize - 1;
+  puint32* hole = PostSDLRowCacheFind(cache, hash);
+  puint32  i    = hole - cache->map;
+
+  *hole = 0;
+
+  for (puint32 j = (i + 1) & mask; cache->map[j]; j = (j + 1) & mask) {
+    puint32 home =
+      PostSDLRowCacheHome(cache, cache->slotHashes[cache->map[j] - 1]);
+
+    // NOTE: an entry stays when its home lies cyclically in (i, j]
+    if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+      continue;
+
+    cache->map[i] = cache->map[j];
+    cache->map[j] = 0;
+    i             = j;
+  }
+}
+
+static void
+PostSDLRowCacheFree(PostSDLRowCache* cache)
+{
+  for (puint32 i = 0; i < cache->numTextures; ++i)
+    if (cache->textures[i] != NULL)
+      SDL_DestroyTexture(cache->textures[i]);
+
+  free(cache->textures);
+  free(cache->slotHashes);
+  free(cache->slotUses);
+  free(cache->map);
+
+  cache->textures    = NULL;
+  cache->slotHashes  = NULL;
+  cache->slotUses    = NULL;
+  cache->map         = NULL;
+  cache->numTextures = 0;
+  cache->numSlots    = 0;
+  cache->usedSlots   = 0;
+  cache->mapSize     = 0;
+}
+
+/** the slot for a new row, the least recently drawn one once all are used */
+static PostError
+PostSDLRowCacheTakeSlot(PostSDLRowCache* cache, puint32* slot)
+{
+  puint32 t;
+
+  if (cache->usedSlots < cache->numSlots)
+    *slot = cache->usedSlots++;
+  else {
+    *slot = 0;
+
+    for (puint32 i = 1; i < cache->numSlots; ++i)
+      if (cache->slotUses[i] < cache->slotUses[*slot])
+        *slot = i;
+
+    PostSDLRowCacheRemove(cache, cache->slotHashes[*slot]);
+  }
+
+  t = *slot / cache->rowsPerTexture;
+
+  if (cache->textures[t] == NULL) {
+    puint32 rows = cache->numSlots - t * cache->rowsPerTexture;
+
+    if (rows > cache->rowsPerTexture)
+      rows = cache->rowsPerTexture;
+
+    cache->textures[t] = SDL_CreateTexture(cache->sdlRenderer,
+                                           SDL_PIXELFORMAT_RGBA32,
+                                           SDL_TEXTUREACCESS_TARGET,
+                                           cache->rowWidth,
+                                           rows * cache->rowHeight);
+
+    // NOTE: a slot whose texture could not be made is never handed out
+    if (cache->textures[t] == NULL) {
+      PostLogErrorA("Could Not Create Row Cache Texture: %s", SDL_GetError());
+      --cache->usedSlots;
+      return POST_ERR_SUBSYS;
+    }
+
+    SDL_SetTextureBlendMode(cache->textures[t], SDL_BLENDMODE_NONE);
+    SDL_SetTextureScaleMode(cache->textures[t], SDL_SCALEMODE_NEAREST);
+  }
+
+  return POST_ERR_NONE;
+}
+
+static SDL_FRect
+PostSDLRowCacheSlotRect(const PostSDLRowCache* cache, puint32 slot)
+{
+  return (SDL_FRect) {
+    .x = 0,
+    .y = (slot % cache->rowsPerTexture) * cache->rowHeight,
+    .w = cache->rowWidth,
+    .h = cache->rowHeight,
+  };
+}
+
+void
+PostSDLRowCacheInit(PostSDLRowCache* cache,
+                    SDL_Renderer*    sdlRenderer,
+                    pusize           budget)
+{
+  memset(cache, 0, sizeof(PostSDLRowCache));
+
+  cache->sdlRenderer = sdlRenderer;
+  cache->budget      = budget;
+}
+
+void
+PostSDLRowCacheFini(PostSDLRowCache* cache)
+{
+  PostSDLRowCacheFree(cache);
+  free(cache->stores);
+
+  memset(cache, 0, sizeof(PostSDLRowCache));
+}
+
+PostError
+PostSDLRowCacheReset(PostSDLRowCache* cache, puint32 width, puint32 height)
+{
+  pusize  rowSize  = (pusize) width * height * 4;
+  puint32 numSlots = 0;
+
+  PostSDLRowCacheFree(cache);
+
+  cache->numStores = 0;
+  cache->rowWidth  = width;
+  cache->rowHeight = height;
+
+  if (rowSize)
+    numSlots = cache->budget / rowSize < POST_SDL_ROW_CACHE_MAX_SLOTS
+                 ? cache->budget / rowSize
+                 : POST_SDL_ROW_CACHE_MAX_SLOTS;
+
+  if (!numSlots)
+    return POST_ERR_NONE;
+
+  cache->rowsPerTexture = POST_SDL_ROW_CACHE_TEXTURE_HEIGHT / height;
+
+  if (!cache->rowsPerTexture)
+    cache->rowsPerTexture = 1;
+
+  // NOTE: the map is kept at most half full so probes stay short
+  cache->mapSize = 1;
+  while (cache->mapSize < numSlots * 2)
+    cache->mapSize *= 2;
+
+  cache->numTextures =
+    (numSlots + cache->rowsPerTexture - 1) / cache->rowsPerTexture;
+  cache->textures   = calloc(cache->numTextures, sizeof(SDL_Texture*));
+  cache->slotHashes = malloc(numSlots * sizeof(puint64));
+  cache->slotUses   = malloc(numSlots * sizeof(puint64));
+  cache->map        = calloc(cache->mapSize, sizeof(puint32));
+
+  if (cache->textures == NULL || cache->slotHashes == NULL ||
+      cache->slotUses == NULL || cache->map == NULL) {
+    PostSDLRowCacheFree(cache);
+    return POST_ERR_OUT_OF_MEMORY;
+  }
+
+  cache->numSlots = numSlots;
+
+  return POST_ERR_NONE;
+}
+
+pbool
+PostSDLRowCacheDraw(PostSDLRowCache* cache, puint64 hash, float y)
+{
+  puint32 slot;
+
+  if (!cache->numSlots)
+    return 0;
+
+  slot = *PostSDLRowCacheFind(cache, hash);
+
+  if (!slot) {
+    ++cache->misses;
+    return 0;
+  }
+
+  --slot;
+
+  SDL_FRect src = PostSDLRowCacheSlotRect(cache, slot);
+  SDL_FRect dst = src;
+  dst.y         = y;
+
+  SDL_RenderTexture(cache->sdlRenderer,
+                    cache->textures[slot / cache->rowsPerTexture],
+                    &src,
+                    &dst);
+
+  cache->slotUses[slot] = ++cache->uses;
+  ++cache->hits;
+
+  return 1;
+}
+
+PostError
+PostSDLRowCacheDefer(PostSDLRowCache* cache, puint64 hash, float y)
+{
+  if (!cache->numSlots)
+    return POST_ERR_NONE;
+
+  if (cache->numStores == cache->maxStores) {
+    puint32 maxStores = cache->maxStores ? cache->maxStores * 2 : 64;
+    PostSDLRowCacheStore* stores =
+      realloc(cache->stores, maxStores * sizeof(PostSDLRowCacheStore));
+
+    if (stores == NULL)
+      return POST_ERR_OUT_OF_MEMORY;
+
+    cache->stores    = stores;
+    cache->maxStores = maxStores;
+  }
+
+  cache->stores[cache->numStores++] =
+    (PostSDLRowCacheStore) { .hash = hash, .y = y };
+
+  return POST_ERR_NONE;
+}
+
+PostError
+PostSDLRowCacheStoreRows(PostSDLRowCache* cache, SDL_Texture* target)
+{
+  PostError error = POST_ERR_NONE;
+
+  for (puint32 i = 0; i < cache->numStores && error == POST_ERR_NONE; ++i) {
+    const PostSDLRowCacheStore* store = cache->stores + i;
+    puint32*                    entry;
+    puint32                     slot;
+
+    // NOTE: rows alike drawn in the same frame are cached once
+    if (*PostSDLRowCacheFind(cache, store->hash))
+      continue;
+
+    error = PostSDLRowCacheTakeSlot(cache, &slot);
+
+    if (error != POST_ERR_NONE)
+      break;
+
+    SDL_FRect dst = PostSDLRowCacheSlotRect(cache, slot);
+    SDL_FRect src = dst;
+    src.y         = store->y;
+
+    SDL_SetRenderTarget(cache->sdlRenderer,
+                        cache->textures[slot / cache->rowsPerTexture]);
+    SDL_RenderTexture(cache->sdlRenderer, target, &src, &dst);
+
+    cache->slotHashes[slot] = store->hash;
+    cache->slotUses[slot]   = ++cache->uses;
+
+    entry  = PostSDLRowCacheFind(cache, store->hash);
+    *entry = slot + 1;
+  }
+
+  cache->numStores = 0;
+
+  return error;
+}
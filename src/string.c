@@ -53,12 +53,52 @@ PostStringAppendChar(PostString* str, char c)
   return POST_ERR_NONE;
 }
 
+PostError
+PostStringAppend(PostString* str, const char* data, pusize len)
+{
+  if (!len)
+    return POST_ERR_NONE;
+
+  PostTry(PostStringReserve(str, str->size + len));
+
+  memcpy(str->buf + str->size, data, len);
+  str->size += len;
+
+  return POST_ERR_NONE;
+}
+
+PostError
+PostStringReserve(PostString* str, pusize cap)
+{
+  pusize newCap = str->cap;
+  char*  buf;
+
+  if (cap <= newCap)
+    return POST_ERR_NONE;
+
+  if (!newCap)
+    newCap = 1;
+
+  while (cap > newCap)
+    newCap <<= 1;
+
+  buf = realloc(str->buf, newCap);
+  if (buf == NULL)
+    return POST_ERR_OUT_OF_MEMORY;
+
+  str->cap = newCap;
+  str->buf = buf;
+
+  return POST_ERR_NONE;
+}
+
 void
 PostStringRelease(PostString* str)
 {
+  free(str->buf);
   str->size = 0;
   str->cap  = 0;
-  free(str->buf);
+  str->buf  = NULL;
 }
 
 char*
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "post/style.h"
+
+static puint32
+PostStyleHash(const PostStyle* style)
+{
+  puint32 words[] = { style->fg, style->bg, style->ul, style->sgr };
+  puint32 hash    = 2166136261u;
+
+  for (pusize i = 0; i < sizeof(words) / sizeof(*words); ++i)
+    hash = (hash ^ words[i]) * 16777619u;
+
+  return (hash ^ hash >> 16) & (POST_STYLE_BUCKETS - 1);
+}
+
+void
+PostStyleTableInit(PostStyleTable* table, const PostStyle* defaultStyle)
+{
+  *table = (PostStyleTable) {
+    .defaultStyle = *defaultStyle,
+    .freeEntry    = POST_STYLE_NONE,
+  };
+
+  memset(table->buckets, 0xFF, sizeof(table->buckets));
+}
+
+void
+PostStyleTableFini(PostStyleTable* table)
+{
+  free(table->entries);
+  table->entries    = NULL;
+  table->numEntries = 0;
+  table->maxEntries = 0;
+}
+
+static PostError
+PostStyleAllocate(PostStyleTable* table, puint16* id)
+{
+  if (table->freeEntry != POST_STYLE_NONE) {
+    *id              = table->freeEntry;
+    table->freeEntry = table->entries[*id].next;
+    return POST_ERR_NONE;
+  }
+
+  // NOTE: entry 0 stands in for the default style so ids start at 1
+  if (!table->numEntries)
+    table->numEntries = 1;
+
+  if (table->numEntries == POST_STYLE_NONE)
+    return POST_ERR_OUT_OF_MEMORY;
+
+  if (table->numEntries >= table->maxEntries) {
+    puint32         maxEntries = table->maxEntries ? table->maxEntries << 1 : 64;
+    PostStyleEntry* entries;
+
+    if (maxEntries > POST_STYLE_NONE)
+      maxEntries = POST_STYLE_NONE;
+
+    entries = realloc(table->entries, maxEntries * sizeof(*entries));
+    if (entries == NULL)
+      return POST_ERR_OUT_OF_MEMORY;
+
+    table->entries    = entries;
+    table->maxEntries = maxEntries;
+  }
+
+  *id = table->numEntries++;
+
+  return POST_ERR_NONE;
+}
+
+PostError
+PostStyleIntern(PostStyleTable* table, const PostStyle* style, puint16* id)
+{
+  puint32 bucket;
+
+  if (PostStyleEqual(style, &table->defaultStyle)) {
+    *id = POST_STYLE_DEFAULT;
+    return POST_ERR_NONE;
+  }
+
+  bucket = PostStyleHash(style);
+
+  for (puint16 i = table->buckets[bucket]; i != POST_STYLE_NONE;
+       i         = table->entries[i].next) {
+    if (PostStyleEqual(style, &table->entries[i].style)) {
+      ++table->entries[i].refs;
+      *id = i;
+      return POST_ERR_NONE;
+    }
+  }
+
+  PostTry(PostStyleAllocate(table, id));
+
+  table->entries[*id] = (PostStyleEntry) {
+    .style = *style,
+    .refs  = 1,
+    .next  = table->buckets[bucket],
+  };
+
+  table->buckets[bucket] = *id;
+  ++table->numLive;
+
+  return POST_ERR_NONE;
+}
+
+void
+PostStyleFree(PostStyleTable* table, puint16 id)
+{
+  puint16* link = table->buckets + PostStyleHash(&table->entries[id].style);
+
+  while (*link != id)
+    link = &table->entries[*link].next;
+
+  *link                   = table->entries[id].next;
+  table->entries[id].next = table->freeEntry;
+  table->freeEntry        = id;
+  --table->numLive;
+}
@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2025 Zachary Lamb
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+// NOTE: the block decoder is built for SSSE3 whatever the baseline and only
+// used when the CPU it runs on has it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define POST_UTF8_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+#include "post/compiler.h"
+#include "post/utf8.h"
+
+/**
+ * decodes one byte, returns 0 when the byte must be fed again because it
+ * ended an invalid sequence
+ */
+static inline pbool
+PostUTF8DecodeByte(PostUTF8Decoder* decoder,
+                   puint8           ch,
+                   puint32*         out,
+                   pusize*          numOut)
+{
+  if (!decoder->needed) {
+    if (ch >= 0xC2 && ch <= 0xDF) {
+      decoder->needed    = 1;
+      decoder->codepoint = ch & 0x1F;
+    } else if (ch >= 0xE0 && ch <= 0xEF) {
+      if (ch == 0xE0)
+        decoder->lower = 0xA0;
+      else if (ch == 0xED)
+        decoder->upper = 0x9F;
+      decoder->needed    = 2;
+      decoder->codepoint = ch & 0xF;
+    } else if (ch >= 0xF0 && ch <= 0xF4) {
+      if (ch == 0xF0)
+        decoder->lower = 0x90;
+      else if (ch == 0xF4)
+        decoder->upper = 0x8F;
+      decoder->needed    = 3;
+      decoder->codepoint = ch & 0x7;
+    } else
+      out[(*numOut)++] = POST_UTF8_REPLACEMENT;
+
+    return 1;
+  }
+
+  if (ch < decoder->lower || ch > decoder->upper) {
+    PostUTF8DecoderReset(decoder);
+    out[(*numOut)++] = POST_UTF8_REPLACEMENT;
+    return 0;
+  }
+
+  decoder->lower     = 0x80;
+  decoder->upper     = 0xBF;
+  decoder->codepoint = (decoder->codepoint << 6) | (ch & 0x3F);
+
+  if (++decoder->seen == decoder->needed) {
+    out[(*numOut)++] = decoder->codepoint;
+    PostUTF8DecoderReset(decoder);
+  }
+
+  return 1;
+}
+
+#if defined(POST_UTF8_SSSE3)
+
+#define TOO_SHORT      (1 << 0)
+#define TOO_LONG       (1 << 1)
+#define OVERLONG_3     (1 << 2)
+#define TOO_LARGE      (1 << 3)
+#define SURROGATE      (1 << 4)
+#define OVERLONG_2     (1 << 5)
+#define TOO_LARGE_1000 (1 << 6)
+#define OVERLONG_4     (1 << 6)
+#define TWO_CONTS      (1 << 7)
+#define CARRY          (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+static const _Alignas(16) puint8 byte1HighTable[16] = {
+  TOO_LONG,
+  TOO_LONG,
+  TOO_LONG,
+  TOO_LONG,
+  TOO_LONG,
+  TOO_LONG,
+  TOO_LONG,
+  TOO_LONG,
+  TWO_CONTS,
+  TWO_CONTS,
+  TWO_CONTS,
+  TWO_CONTS,
+  TOO_SHORT | OVERLONG_2,
+  TOO_SHORT,
+  TOO_SHORT | OVERLONG_3 | SURROGATE,
+  TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+};
+
+static const _Alignas(16) puint8 byte1LowTable[16] = {
+  CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+  CARRY | OVERLONG_2,
+  CARRY,
+  CARRY,
+  CARRY | TOO_LARGE,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+};
+
+static const _Alignas(16) puint8 byte2HighTable[16] = {
+  TOO_SHORT,
+  TOO_SHORT,
+  TOO_SHORT,
+  TOO_SHORT,
+  TOO_SHORT,
+  TOO_SHORT,
+  TOO_SHORT,
+  TOO_SHORT,
+  TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+  TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+  TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+  TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+  TOO_SHORT,
+  TOO_SHORT,
+  TOO_SHORT,
+  TOO_SHORT,
+};
+
+/**
+ * validates 16 bytes that start on a sequence boundary using the lookup
+ * method from Keiser and Lemire, "Validating UTF-8 In Less Than One
+ * Instruction Per Byte". Returns the number of leading non-ASCII bytes that
+ * form complete, valid sequences or 0 if the block has an error.
+ */
+TARGET("ssse3") static inline pusize
+PostUTF8ValidateBlock(const puint8* data)
+{
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+
+  // NOTE: the block starts on a boundary so the previous bytes act as ASCII
+  __m128i input = _mm_loadu_si128((const __m128i*) data);
+  __m128i zero  = _mm_setzero_si128();
+  __m128i prev1 = _mm_alignr_epi8(input, zero, 15);
+  __m128i prev2 = _mm_alignr_epi8(input, zero, 14);
+  __m128i prev3 = _mm_alignr_epi8(input, zero, 13);
+
+  __m128i byte1High =
+    _mm_shuffle_epi8(_mm_load_si128((const __m128i*) byte1HighTable),
+                     _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+  __m128i byte1Low =
+    _mm_shuffle_epi8(_mm_load_si128((const __m128i*) byte1LowTable),
+                     _mm_and_si128(prev1, nibble));
+  __m128i byte2High =
+    _mm_shuffle_epi8(_mm_load_si128((const __m128i*) byte2HighTable),
+                     _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+  __m128i special =
+    _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+  // NOTE: only 111_____ and 1111____ leave the high bit set here
+  __m128i third  = _mm_subs_epu8(prev2, _mm_set1_epi8((char) (0xE0 - 0x80)));
+  __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8((char) (0xF0 - 0x80)));
+  __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth),
+                                 _mm_set1_epi8((char) 0x80));
+  __m128i error  = _mm_xor_si128(must23, special);
+
+  pusize  valid = 16;
+  puint32 ascii = ~(puint32) _mm_movemask_epi8(input) & 0xFFFF;
+
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) != 0xFFFF)
+    return 0;
+
+  // NOTE: a sequence cut short by the end of the block is left for the next
+  if (data[13] >= 0xF0)
+    valid = 13;
+  else if (data[14] >= 0xE0)
+    valid = 14;
+  else if (data[15] >= 0xC0)
+    valid = 15;
+
+  // NOTE: ASCII ends the run, sequences before it are complete
+  if (ascii && (pusize) __builtin_ctz(ascii) < valid)
+    valid = __builtin_ctz(ascii);
+
+  return valid;
+}
+
+static inline pusize
+PostUTF8DecodeValid(const puint8* data, pusize len, puint32* out)
+{
+  pusize numOut = 0;
+
+  for (pusize i = 0; i < len;) {
+    puint8 ch = data[i];
+
+    if (ch < 0xE0) {
+      out[numOut++] = ((ch & 0x1F) << 6) | (data[i + 1] & 0x3F);
+      i += 2;
+    } else if (ch < 0xF0) {
+      out[numOut++] = ((ch & 0xF) << 12) | ((data[i + 1] & 0x3F) << 6) |
+                      (data[i + 2] & 0x3F);
+      i += 3;
+    } else {
+      out[numOut++] = ((ch & 0x7) << 18) | ((data[i + 1] & 0x3F) << 12) |
+                      ((data[i + 2] & 0x3F) << 6) | (data[i + 3] & 0x3F);
+      i += 4;
+    }
+  }
+
+  return numOut;
+}
+
+/**
+ * decodes the leading run of valid sequences in 16 bytes, returns the number
+ * of bytes decoded or 0 if the block has an error
+ */
+TARGET("ssse3") static pusize
+PostUTF8DecodeBlock(const puint8* data, puint32* out, pusize* numOut)
+{
+  pusize valid = PostUTF8ValidateBlock(data);
+
+  if (valid)
+    *numOut += PostUTF8DecodeValid(data, valid, out + *numOut);
+
+  return valid;
+}
+
+#endif
+
+pusize
+PostUTF8Decode(PostUTF8Decoder* decoder,
+               const puint8*    data,
+               pusize           len,
+               puint32*         out,
+               pusize           maxOut,
+               pusize*          numOut)
+{
+  pusize i = 0;
+
+#if defined(POST_UTF8_SSSE3)
+  pbool ssse3 = __builtin_cpu_supports("ssse3");
+#endif
+
+  *numOut = 0;
+
+  while (i < len && *numOut < maxOut) {
+    puint8 ch = data[i];
+
+    if (ch < 0x80) {
+      if (!decoder->needed)
+        break;
+      // NOTE: an ASCII byte cuts the pending sequence short
+      PostUTF8DecoderReset(decoder);
+      out[(*numOut)++] = POST_UTF8_REPLACEMENT;
+      break;
+    }
+
+#if defined(POST_UTF8_SSSE3)
+    if (ssse3 && !decoder->needed && len - i >= 16 && maxOut - *numOut >= 16) {
+      pusize valid = PostUTF8DecodeBlock(data + i, out, numOut);
+
+      if (valid) {
+        i += valid;
+        continue;
+      }
+    }
+#endif
+
+    if (PostUTF8DecodeByte(decoder, ch, out, numOut))
+      ++i;
+  }
+
+  return i;
+}
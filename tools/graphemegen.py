@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+#
+# Generates the two level Grapheme_Cluster_Break table used by
+# PostGraphemeBreak, in the same layout as the width table.
+#
+# The Python interpreter only bundles UnicodeData and EastAsianWidth, so the
+# break classes are derived from general categories (UAX #29 section 3.1):
+#
+#   Control     - Cc, Zl, Zp and Cf other than the ones below
+#   Extend      - Mn, Me, ZWNJ, emoji modifiers, tags and halfwidth sound marks
+#   SpacingMark - Mc, Thai and Lao SARA AM
+#   L/V/T/LV/LVT from the Hangul jamo and syllable ranges
+#
+# Prepend is left out, its marks are zero width and have no cell to hold the
+# cluster they would start.
+#
+# Extended_Pictographic is folded in as its own class from the emoji-data.txt
+# ranges below, every one of those codepoints is otherwise Other.
+#
+# Usage: graphemegen.py OUT_H OUT_C
+
+import sys
+import unicodedata
+
+sys.dont_write_bytecode = True
+
+from widthgen import MAX_CODEPOINT, emit_table
+
+CLASSES = [
+    'OTHER', 'CR', 'LF', 'CONTROL', 'EXTEND', 'ZWJ', 'REGIONAL_INDICATOR',
+    'SPACING_MARK', 'L', 'V', 'T', 'LV', 'LVT', 'PICTOGRAPHIC',
+]
+
+PICTOGRAPHIC = (
+    (0x00A9, 0x00A9), (0x00AE, 0x00AE), (0x203C, 0x203C), (0x2049, 0x2049),
+    (0x2122, 0x2122), (0x2139, 0x2139), (0x2194, 0x2199), (0x21A9, 0x21AA),
+    (0x231A, 0x231B), (0x2328, 0x2328), (0x2388, 0x2388), (0x23CF, 0x23CF),
+    (0x23E9, 0x23F3), (0x23F8, 0x23FA), (0x24C2, 0x24C2), (0x25AA, 0x25AB),
+    (0x25B6, 0x25B6), (0x25C0, 0x25C0), (0x25FB, 0x25FE), (0x2600, 0x2605),
+    (0x2607, 0x2612), (0x2614, 0x2685), (0x2690, 0x2705), (0x2708, 0x2712),
+    (0x2714, 0x2714), (0x2716, 0x2716), (0x271D, 0x271D), (0x2721, 0x2721),
+    (0x2728, 0x2728), (0x2733, 0x2734), (0x2744, 0x2744), (0x2747, 0x2747),
+    (0x274C, 0x274C), (0x274E, 0x274E), (0x2753, 0x2755), (0x2757, 0x2757),
+    (0x2763, 0x2767), (0x2795, 0x2797), (0x27A1, 0x27A1), (0x27B0, 0x27B0),
+    (0x27BF, 0x27BF), (0x2934, 0x2935), (0x2B05, 0x2B07), (0x2B1B, 0x2B1C),
+    (0x2B50, 0x2B50), (0x2B55, 0x2B55), (0x3030, 0x3030), (0x303D, 0x303D),
+    (0x3297, 0x3297), (0x3299, 0x3299), (0x1F000, 0x1F0FF),
+    (0x1F10D, 0x1F10F), (0x1F12F, 0x1F12F), (0x1F16C, 0x1F171),
+    (0x1F17E, 0x1F17F), (0x1F18E, 0x1F18E), (0x1F191, 0x1F19A),
+    (0x1F1AD, 0x1F1E5), (0x1F201, 0x1F20F), (0x1F21A, 0x1F21A),
+    (0x1F22F, 0x1F22F), (0x1F232, 0x1F23A), (0x1F23C, 0x1F23F),
+    (0x1F249, 0x1F3FA), (0x1F400, 0x1F53D), (0x1F546, 0x1F64F),
+    (0x1F680, 0x1F6FF), (0x1F774, 0x1F77F), (0x1F7D5, 0x1F7FF),
+    (0x1F80C, 0x1F80F), (0x1F848, 0x1F84F), (0x1F85A, 0x1F85F),
+    (0x1F888, 0x1F88F), (0x1F8AE, 0x1F8FF), (0x1F90C, 0x1F93A),
+    (0x1F93C, 0x1F945), (0x1F947, 0x1FAFF), (0x1FC00, 0x1FFFD),
+)
+
+
+def within(cp, ranges):
+    return any(lo <= cp <= hi for lo, hi in ranges)
+
+
+def hangul(cp):
+    if 0x1100 <= cp <= 0x115F or 0xA960 <= cp <= 0xA97C:
+        return 'L'
+    if 0x1160 <= cp <= 0x11A7 or 0xD7B0 <= cp <= 0xD7C6:
+        return 'V'
+    if 0x11A8 <= cp <= 0x11FF or 0xD7CB <= cp <= 0xD7FB:
+        return 'T'
+    if 0xAC00 <= cp <= 0xD7A3:
+        return 'LV' if (cp - 0xAC00) % 28 == 0 else 'LVT'
+    return None
+
+
+def grapheme_class(cp):
+    if cp == 0x0D:
+        return 'CR'
+    if cp == 0x0A:
+        return 'LF'
+    if cp == 0x200D:
+        return 'ZWJ'
+    if 0x1F1E6 <= cp <= 0x1F1FF:
+        return 'REGIONAL_INDICATOR'
+    if within(cp, PICTOGRAPHIC):
+        return 'PICTOGRAPHIC'
+    if (cp == 0x200C or 0x1F3FB <= cp <= 0x1F3FF or
+            0xE0020 <= cp <= 0xE007F or 0xFF9E <= cp <= 0xFF9F):
+        return 'EXTEND'
+
+    jamo = hangul(cp)
+    if jamo:
+        return jamo
+
+    category = unicodedata.category(chr(cp))
+
+    if category in ('Mn', 'Me'):
+        return 'EXTEND'
+    if category == 'Mc' or cp in (0x0E33, 0x0EB3):
+        return 'SPACING_MARK'
+    if category in ('Cc', 'Cf', 'Zl', 'Zp'):
+        return 'CONTROL'
+    return 'OTHER'
+
+
+def emit(outH, outC):
+    classes = [CLASSES.index(grapheme_class(cp)) for cp in range(MAX_CODEPOINT)]
+
+    outH.write('// generated by tools/graphemegen.py, do not edit\n\n')
+    outH.write('#ifndef POST_GRAPHEMETABLE_H\n#define POST_GRAPHEMETABLE_H 1\n\n')
+    outH.write('#include "post/types.h"\n\n')
+    for i, name in enumerate(CLASSES):
+        outH.write(f'#define POST_GRAPHEME_{name} {i}\n')
+    outH.write('\n')
+
+    outC.write('// generated by tools/graphemegen.py, do not edit\n\n')
+    outC.write('#include "post/graphemetable.h"\n\n')
+
+    emit_table(outH, outC, 'Grapheme', classes, 4)
+
+    outH.write('#endif\n')
+
+
+if __name__ == '__main__':
+    with open(sys.argv[1], 'w') as outH, open(sys.argv[2], 'w') as outC:
+        emit(outH, outC)
@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+#
+# Generates the packed transition table for the DEC compatible state machine
+# described by Paul Williams (https://vt100.net/emu/dec_ansi_parser), adapted
+# for a UTF-8 terminal:
+#
+#   - C1 controls are not recognized, bytes >= 0x80 only carry string payload
+#   - ':' separates sub-parameters instead of invalidating the sequence
+#   - BEL terminates OSC strings like it does in xterm
+#   - DEL is ignored everywhere
+#
+# Each entry is (next state << 4) | action, a next state of POST_VT_STAY
+# means the byte is handled without leaving the current state (and without
+# running exit or entry actions).
+
+import sys
+
+STATES = [
+    'GROUND',
+    'ESCAPE',
+    'ESCAPE_INTERMEDIATE',
+    'CSI_ENTRY',
+    'CSI_PARAM',
+    'CSI_INTERMEDIATE',
+    'CSI_IGNORE',
+    'DCS_ENTRY',
+    'DCS_PARAM',
+    'DCS_INTERMEDIATE',
+    'DCS_PASSTHROUGH',
+    'DCS_IGNORE',
+    'OSC_STRING',
+    'SOS_PM_APC_STRING',
+]
+
+ACTIONS = [
+    'NONE',
+    'IGNORE',
+    'PRINT',
+    'EXECUTE',
+    'CLEAR',
+    'COLLECT',
+    'PARAM',
+    'ESC_DISPATCH',
+    'CSI_DISPATCH',
+    'HOOK',
+    'PUT',
+    'UNHOOK',
+    'OSC_START',
+    'OSC_PUT',
+    'OSC_END',
+]
+
+STAY = 15
+
+assert len(STATES) < STAY and len(ACTIONS) <= 16
+
+C0 = [*range(0x00, 0x18), 0x19, *range(0x1C, 0x20)]
+
+ENTRY = {
+    'ESCAPE': 'CLEAR',
+    'CSI_ENTRY': 'CLEAR',
+    'DCS_ENTRY': 'CLEAR',
+    'DCS_PASSTHROUGH': 'HOOK',
+    'OSC_STRING': 'OSC_START',
+}
+
+EXIT = {
+    'DCS_PASSTHROUGH': 'UNHOOK',
+    'OSC_STRING': 'OSC_END',
+}
+
+
+def r(lo, hi):
+    return range(lo, hi + 1)
+
+
+# state -> list of (bytes, action, next state)
+RULES = {
+    'GROUND': [
+        (C0, 'EXECUTE', None),
+        (r(0x20, 0x7E), 'PRINT', None),
+        (r(0x80, 0xFF), 'PRINT', None),
+    ],
+    'ESCAPE': [
+        (C0, 'EXECUTE', None),
+        (r(0x20, 0x2F), 'COLLECT', 'ESCAPE_INTERMEDIATE'),
+        (r(0x30, 0x4F), 'ESC_DISPATCH', 'GROUND'),
+        (r(0x51, 0x57), 'ESC_DISPATCH', 'GROUND'),
+        ([0x59, 0x5A, 0x5C], 'ESC_DISPATCH', 'GROUND'),
+        (r(0x60, 0x7E), 'ESC_DISPATCH', 'GROUND'),
+        ([0x5B], 'NONE', 'CSI_ENTRY'),
+        ([0x5D], 'NONE', 'OSC_STRING'),
+        ([0x50], 'NONE', 'DCS_ENTRY'),
+        ([0x58, 0x5E, 0x5F], 'NONE', 'SOS_PM_APC_STRING'),
+    ],
+    'ESCAPE_INTERMEDIATE': [
+        (C0, 'EXECUTE', None),
+        (r(0x20, 0x2F), 'COLLECT', None),
+        (r(0x30, 0x7E), 'ESC_DISPATCH', 'GROUND'),
+    ],
+    'CSI_ENTRY': [
+        (C0, 'EXECUTE', None),
+        (r(0x20, 0x2F), 'COLLECT', 'CSI_INTERMEDIATE'),
+        (r(0x30, 0x3B), 'PARAM', 'CSI_PARAM'),
+        (r(0x3C, 0x3F), 'COLLECT', 'CSI_PARAM'),
+        (r(0x40, 0x7E), 'CSI_DISPATCH', 'GROUND'),
+    ],
+    'CSI_PARAM': [
+        (C0, 'EXECUTE', None),
+        (r(0x30, 0x3B), 'PARAM', None),
+        (r(0x3C, 0x3F), 'NONE', 'CSI_IGNORE'),
+        (r(0x20, 0x2F), 'COLLECT', 'CSI_INTERMEDIATE'),
+        (r(0x40, 0x7E), 'CSI_DISPATCH', 'GROUND'),
+    ],
+    'CSI_INTERMEDIATE': [
+        (C0, 'EXECUTE', None),
+        (r(0x20, 0x2F), 'COLLECT', None),
+        (r(0x30, 0x3F), 'NONE', 'CSI_IGNORE'),
+        (r(0x40, 0x7E), 'CSI_DISPATCH', 'GROUND'),
+    ],
+    'CSI_IGNORE': [
+        (C0, 'EXECUTE', None),
+        (r(0x40, 0x7E), 'NONE', 'GROUND'),
+    ],
+    'DCS_ENTRY': [
+        (r(0x20, 0x2F), 'COLLECT', 'DCS_INTERMEDIATE'),
+        (r(0x30, 0x3B), 'PARAM', 'DCS_PARAM'),
+        (r(0x3C, 0x3F), 'COLLECT', 'DCS_PARAM'),
+        (r(0x40, 0x7E), 'NONE', 'DCS_PASSTHROUGH'),
+    ],
+    'DCS_PARAM': [
+        (r(0x30, 0x3B), 'PARAM', None),
+        (r(0x3C, 0x3F), 'NONE', 'DCS_IGNORE'),
+        (r(0x20, 0x2F), 'COLLECT', 'DCS_INTERMEDIATE'),
+        (r(0x40, 0x7E), 'NONE', 'DCS_PASSTHROUGH'),
+    ],
+    'DCS_INTERMEDIATE': [
+        (r(0x20, 0x2F), 'COLLECT', None),
+        (r(0x30, 0x3F), 'NONE', 'DCS_IGNORE'),
+        (r(0x40, 0x7E), 'NONE', 'DCS_PASSTHROUGH'),
+    ],
+    'DCS_PASSTHROUGH': [
+        (C0, 'PUT', None),
+        (r(0x20, 0x7E), 'PUT', None),
+        (r(0x80, 0xFF), 'PUT', None),
+    ],
+    'DCS_IGNORE': [],
+    'OSC_STRING': [
+        (r(0x20, 0x7E), 'OSC_PUT', None),
+        (r(0x80, 0xFF), 'OSC_PUT', None),
+        ([0x07], 'NONE', 'GROUND'),
+    ],
+    'SOS_PM_APC_STRING': [],
+}
+
+# applied last so they win over the per state rules
+ANYWHERE = [
+    ([0x18, 0x1A], 'EXECUTE', 'GROUND'),
+    ([0x1B], 'NONE', 'ESCAPE'),
+]
+
+
+def build():
+    table = []
+
+    for state in STATES:
+        # NOTE: anything not covered is ignored without a transition
+        row = [(STAY << 4) | ACTIONS.index('IGNORE')] * 256
+
+        for chars, action, nextState in RULES[state] + ANYWHERE:
+            nextIndex = STAY if nextState is None else STATES.index(nextState)
+            for ch in chars:
+                row[ch] = (nextIndex << 4) | ACTIONS.index(action)
+
+        table.append(row)
+
+    return table
+
+
+def emit(out):
+    table = build()
+
+    out.write('// generated by tools/vtgen.py, do not edit\n\n')
+    out.write('#ifndef POST_VTTABLE_H\n#define POST_VTTABLE_H 1\n\n')
+    out.write('#include "post/types.h"\n\n')
+
+    for i, state in enumerate(STATES):
+        out.write(f'#define POST_VT_STATE_{state} {i}\n')
+    out.write(f'#define POST_VT_STAY {STAY}\n\n')
+
+    for i, action in enumerate(ACTIONS):
+        out.write(f'#define POST_VT_ACTION_{action} {i}\n')
+    out.write('\n')
+
+    out.write('#define PostVTNextState(T) ((T) >> 4)\n')
+    out.write('#define PostVTAction(T)    ((T) & 0xF)\n\n')
+
+    out.write(f'static const puint8 postVTTransitions[{len(STATES)}][256] = {{\n')
+    for state, row in zip(STATES, table):
+        out.write(f'  [POST_VT_STATE_{state}] = {{\n')
+        for i in range(0, 256, 16):
+            out.write('    ' + ', '.join(f'0x{v:02X}' for v in row[i:i + 16]) + ',\n')
+        out.write('  },\n')
+    out.write('};\n\n')
+
+    for name, actions in (('Entry', ENTRY), ('Exit', EXIT)):
+        out.write(f'static const puint8 postVT{name}Actions[{len(STATES)}] = {{\n')
+        for state in STATES:
+            action = actions.get(state, 'NONE')
+            out.write(f'  [POST_VT_STATE_{state}] = POST_VT_ACTION_{action},\n')
+        out.write('};\n\n')
+
+    out.write('#endif\n')
+
+
+if __name__ == '__main__':
+    with open(sys.argv[1], 'w') as out:
+        emit(out)
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+#
+# Generates the two level codepoint width table used by PostCodepointWidth.
+#
+# Widths come from the Unicode Character Database bundled with the Python
+# interpreter (unicodedata.unidata_version is recorded in the output):
+#
+#   0 - nonspacing and enclosing marks, format characters (except U+00AD),
+#       controls and Hangul medial vowels / final consonants
+#   2 - East Asian Wide and Fullwidth, unassigned codepoints only in the
+#       ranges UAX #11 reserves for ideographs
+#   1 - everything else
+#
+# The codepoint space is cut into blocks of 1 << SHIFT entries, identical
+# blocks are stored once and an index maps codepoint >> SHIFT to its block,
+# the shift that gives the smallest tables is picked. Widths are packed four
+# to a byte, two bits each, lowest codepoint in the lowest bits.
+#
+# Usage: widthgen.py OUT_H OUT_C
+
+import sys
+import unicodedata
+
+MAX_CODEPOINT = 0x110000
+
+# unassigned codepoints default to Wide here and Neutral elsewhere, the
+# bundled database reports every unassigned codepoint as Fullwidth
+DEFAULT_WIDE = (
+    (0x3400, 0x4DBF),
+    (0x4E00, 0x9FFF),
+    (0xF900, 0xFAFF),
+    (0x20000, 0x2FFFD),
+    (0x30000, 0x3FFFD),
+)
+
+
+def width(cp):
+    ch = chr(cp)
+    category = unicodedata.category(ch)
+
+    if category in ('Mn', 'Me', 'Cc') or (category == 'Cf' and cp != 0xAD):
+        return 0
+    if 0x1160 <= cp <= 0x11FF or 0xD7B0 <= cp <= 0xD7FF:
+        return 0
+    if category == 'Cn':
+        return 2 if any(lo <= cp <= hi for lo, hi in DEFAULT_WIDE) else 1
+    if unicodedata.east_asian_width(ch) in ('W', 'F'):
+        return 2
+    return 1
+
+
+def split(values, shift, bits):
+    size = 1 << shift
+    blocks, index, seen = [], [], {}
+
+    for start in range(0, MAX_CODEPOINT, size):
+        block = tuple(values[start:start + size])
+        if block not in seen:
+            seen[block] = len(blocks)
+            blocks.append(block)
+        index.append(seen[block])
+
+    indexSize = 1 if len(blocks) <= 256 else 2
+    return len(index) * indexSize + len(blocks) * size * bits // 8, index, blocks
+
+
+def emit_table(outH, outC, name, values, bits):
+    """
+    writes the declarations of post<name>Index and post<name>Blocks to outH
+    and their definitions to outC, values are packed 8 / bits to a byte
+    """
+    shift = min(range(4, 12), key=lambda s: split(values, s, bits)[0])
+    _, index, blocks = split(values, shift, bits)
+    indexType = 'puint8' if len(blocks) <= 256 else 'puint16'
+    size = 1 << shift
+    perByte = 8 // bits
+    blocksSize = len(blocks) * size // perByte
+    macro = name.upper()
+
+    outH.write(f'#define POST_{macro}_SHIFT {shift}\n')
+    outH.write(f'#define POST_{macro}_MASK  0x{size - 1:X}\n\n')
+    outH.write(f'extern const {indexType} post{name}Index[{len(index)}];\n')
+    outH.write(f'extern const puint8 post{name}Blocks[{blocksSize}];\n\n')
+
+    outC.write(f'const {indexType} post{name}Index[{len(index)}] = {{\n')
+    for i in range(0, len(index), 16):
+        outC.write('  ' + ', '.join(str(v) for v in index[i:i + 16]) + ',\n')
+    outC.write('};\n\n')
+    outC.write(f'const puint8 post{name}Blocks[{blocksSize}] = {{\n')
+    for block in blocks:
+        packed = [sum(block[i + j] << (j * bits) for j in range(perByte))
+                  for i in range(0, size, perByte)]
+        for i in range(0, len(packed), 16):
+            outC.write('  ' + ', '.join(f'0x{v:02X}' for v in packed[i:i + 16]) + ',\n')
+    outC.write('};\n')
+
+
+def emit(outH, outC):
+    outH.write('// generated by tools/widthgen.py, do not edit\n\n')
+    outH.write('#ifndef POST_WIDTHTABLE_H\n#define POST_WIDTHTABLE_H 1\n\n')
+    outH.write('#include "post/types.h"\n\n')
+    outH.write(f'#define POST_WIDTH_UNICODE_VERSION "{unicodedata.unidata_version}"\n')
+
+    outC.write('// generated by tools/widthgen.py, do not edit\n\n')
+    outC.write('#include "post/widthtable.h"\n\n')
+
+    emit_table(outH, outC, 'Width', [width(cp) for cp in range(MAX_CODEPOINT)], 2)
+
+    outH.write('#endif\n')
+
+
+if __name__ == '__main__':
+    with open(sys.argv[1], 'w') as outH, open(sys.argv[2], 'w') as outC:
+        emit(outH, outC)